@@ -57,6 +57,7 @@
 #include "bv/BVParser.h"
 #include "amo/AMOTheory.h"
 #include "amo/AMOParser.h"
+#include "pb/WatchedPbParser.h"
 #include "core/Optimize.h"
 using namespace Monosat;
 using namespace std;
@@ -253,6 +254,18 @@ void selectAlgorithms(){
 				((string) opt_allpairs_alg).c_str());
 		exit(1);
 	}
+
+	decisionheuristic = DecisionHeuristic::VSIDS;
+	if (!strcasecmp(opt_decision_heuristic, "vsids")) {
+		decisionheuristic = DecisionHeuristic::VSIDS;
+	} else if (!strcasecmp(opt_decision_heuristic, "vmtf")) {
+		decisionheuristic = DecisionHeuristic::VMTF;
+	} else if (!strcasecmp(opt_decision_heuristic, "chb")) {
+		decisionheuristic = DecisionHeuristic::CHB;
+	} else {
+		fprintf(stderr, "Error: unknown decision heuristic %s, aborting\n", ((string) opt_decision_heuristic).c_str());
+		exit(1);
+	}
 }
 
 void processSymbols(vec<std::pair<int, std::string> > & symbols,vec<Lit> & assume,const char * assume_str ,const char* opt_assume_symbols, bool using_symbols_asp=false){
@@ -499,6 +512,7 @@ int main(int argc, char** argv) {
 		BoolOption opt_witness("MAIN", "witness", "print solution", false);
 		StringOption opt_witness_file("MAIN", "witness-file", "write witness to file", "");
 		StringOption opt_theory_witness_file("MAIN", "theory-witness-file", "write witness for theories to file", "");
+		StringOption opt_stats_json("MAIN", "stats-json", "write solver and theory statistics (as JSON) to file after solving", "");
 
 		BoolOption opb("PB", "opb", "Parse the input as pseudo-boolean constraints in .opb format", false);
 		BoolOption precise("GEOM", "precise",
@@ -616,6 +630,9 @@ int main(int argc, char** argv) {
 		AMOParser<char *, SimpSolver> amo;
 		parser.addParser(&amo);
 
+		WatchedPbParser<char *, SimpSolver> pbParser;
+		parser.addParser(&pbParser);
+
 
 		if (precise) {
 			GeometryParser<char *, SimpSolver, mpq_class> * geometryParser = new GeometryParser<char *, SimpSolver, mpq_class>();
@@ -812,6 +829,20 @@ int main(int argc, char** argv) {
 			printStats(S);
 
 		}
+		if (strlen(opt_stats_json) > 0) {
+			std::ofstream stats_out(opt_stats_json, ios::out);
+			if (stats_out) {
+				stats_out << "{\"result\":\"" << (ret == l_True ? "sat" : ret == l_False ? "unsat" : "unknown") << "\"";
+				stats_out << ",\"parsing_time\":" << parsing_time << ",\"preprocessing_time\":" << preprocessing_time
+						<< ",\"solving_time\":" << solving_time << ",\"cpu_time\":" << cpuTime() << ",\"peak_memory_mb\":"
+						<< memUsedPeak();
+				stats_out << ",\"solver\":";
+				S.writeStatsJSON(stats_out);
+				stats_out << "}\n";
+			} else {
+				fprintf(stderr, "Failed to write stats to file!\n");
+			}
+		}
 		fflush(stdout);
 
 		return (ret == l_True ? 10 : ret == l_False ? 20 : 0);
@@ -42,17 +42,22 @@ class AMOParser: public Parser<B, Solver> {
 	using Parser<B, Solver>::mapVar;
 
 	vec<Var> vars;
+	AMOTheory * theory=nullptr;//all at-most-one constraints share a single theory, created on demand
 	
 public:
-	AMOParser():Parser<B, Solver> ("At-Most-One") {
+	AMOParser(AMOTheory * theory=nullptr):Parser<B, Solver> ("At-Most-One"),theory(theory) {
 		
+	}
+	AMOTheory * getTheory()const{
+		return theory;
 	}
 	bool parseLine(B& in, Solver& S) {
 		
 		skipWhitespace(in);
 		if (*in == EOF)
 			return false;
-		if (match(in,"amo")){
+		bool exactly_one=false;
+		if (match(in,"amo") || (exactly_one=match(in,"exactly_one"))){
 			//read in amo constraints the same way as clauses, except that all ints are interpreted as variables, not lits, for now:
 			vars.clear();
 			for (;;) {
@@ -67,12 +72,11 @@ public:
 				var= mapVar(S,var);
 				vars.push(var);
 			}
-			if(vars.size()>1){
+			if(vars.size()>1 || exactly_one){
 				//else this constraint has no effect
-				AMOTheory * amo = new AMOTheory(&S);
-				for (Var v : vars)
-					amo->addVar(v);
-
+				if(!theory)
+					theory = new AMOTheory(&S);
+				theory->addGroup(vars,exactly_one);
 			}
 			return true;
 		}
@@ -23,26 +23,47 @@
 #define AMOTHEORY_H_
 
 #include "mtl/Vec.h"
+#include "mtl/Sort.h"
 #include "core/SolverTypes.h"
 #include "core/Theory.h"
+#include "core/Config.h"
 
 namespace Monosat {
 
 
-//At-Most-One theory. This is a special case of PB constraints, for handling at-most-one constraints.
-//Each instance of this theory supports a _single_ at-most-one constraint; to implement multiple such constraints, instantiate multiple copies of the theory.
+//At-Most-One theory. This is a special case of PB constraints, for handling at-most-one (and exactly-one) constraints.
+//A single instance of this theory handles all of the at-most-one constraints in the solver; each constraint is a 'group'
+//of variables, and each variable keeps an index of the groups it belongs to (a variable may belong to several groups).
 class AMOTheory: public Theory {
 	Solver * S;
 	int theory_index=-1;
 
+	struct Group{
+		int begin;//position of this group's variables in 'members'
+		int size;
+		bool exactly_one;
+		Var true_var;//the first variable of this group that was assigned true, or var_Undef
+		int n_true;//number of variables in this group assigned true (if more than 1, there is a conflict)
+		int n_false;//number of variables in this group assigned false
+	};
+
 public:
 
 	CRef assign_false_reason;
-	//CRef assign_true_reason;
+	CRef assign_true_reason;//only used by exactly-one groups
+
+	vec<Group> groups;
+	vec<Var> members;//variables of each group, stored contiguously
+	vec<vec<int>> var_groups;//for each variable, the groups it is a member of
+	vec<lbool> assigns;//assignments that have been enqueued to this theory
+	vec<int> reason_group;//for each variable that this theory assigned, the group responsible for that assignment
+	vec<Var> replacement;//if a var was already attached to another theory, it is replaced by an equivalent var in this theory
 
-	vec<Var> amo;//list of variables, at most one of which should be true.
+	vec<int> propagation_queue;//groups that have pending propagations (if opt_amo_eager_prop is false, or for exactly-one groups)
+	vec<bool> in_queue;
+	vec<Lit> conflict_clause;//non-empty if a conflict was detected during enqueueTheory
 
-	vec<Lit> tmp_clause;
+	vec<Var> tmp_vars;
 
 	double propagationtime=0;
 	long stats_propagations=0;
@@ -51,29 +72,58 @@ public:
 	long stats_reasons = 0;
 	long stats_conflicts = 0;
 
-	Var true_var=var_Undef;
-	Var conflict_var=var_Undef;
-	bool needs_propagation=false;
-
 public:
 	
 	AMOTheory(Solver * S) :
 			S(S) {
 		S->addTheory(this);
 		assign_false_reason=S->newReasonMarker(this);
-		//assign_true_reason=S->newReasonMarker(this);
-
+		assign_true_reason=S->newReasonMarker(this);
 	}
 	~AMOTheory() {
 	}
 	;
 
-	//Add a variable (not literal!) to the set of which at most one may be true.
-	void addVar(Var solverVar){
-		S->newTheoryVar(solverVar, getTheoryIndex(),solverVar);//using same variable indices in the theory as out of the theory
-		amo.push(solverVar);
+	//Add a constraint asserting that at most one (or, if exactlyOne is true, exactly one) of the given variables (not literals!) is true.
+	void addGroup(const vec<Var> & vars, bool exactlyOne=false){
+		S->cancelUntil(0);
+		vars.copyTo(tmp_vars);
+		sort(tmp_vars);
+		int i,j=0;
+		for(i = 0;i<tmp_vars.size();i++){
+			if(j>0 && tmp_vars[j-1]==tmp_vars[i]){
+				//a variable that appears twice in a group can never be true
+				S->addClause(mkLit(tmp_vars[i],true));
+			}else{
+				tmp_vars[j++]=tmp_vars[i];
+			}
+		}
+		tmp_vars.shrink(i-j);
+
+		if(tmp_vars.size()==0){
+			if(exactlyOne)
+				S->addEmptyClause();
+			return;
+		}else if (tmp_vars.size()==1){
+			//else this constraint has no effect
+			if(exactlyOne)
+				S->addClause(mkLit(tmp_vars[0]));
+			return;
+		}
+
+		int groupID = groups.size();
+		groups.push({members.size(),tmp_vars.size(),exactlyOne,var_Undef,0,0});
+		in_queue.push(false);
+		for(Var v:tmp_vars){
+			Var theoryVar = toTheory(v);
+			members.push(theoryVar);
+			var_groups[theoryVar].push(groupID);
+		}
 	}
 
+	int nGroups()const{
+		return groups.size();
+	}
 
 	inline int getTheoryIndex() {
 		return theory_index;
@@ -85,76 +135,110 @@ public:
 
 	}
 	inline void backtrackUntil(int untilLevel){
-
+		//pending propagations and conflicts are re-checked against the current assignment before they are applied.
 	}
 	inline int decisionLevel() {
 		return S->decisionLevel();
 	}
 	inline void undecideTheory(Lit l){
-		if(var(l)==true_var){
-			needs_propagation=false;
-			true_var=var_Undef;
-			assert(conflict_var==var_Undef);
-		}
-		if(var(l)==conflict_var){
-			conflict_var=var_Undef;
+		Var v = var(l);
+		if(assigns[v]==l_Undef)
+			return;//this assignment was never enqueued in the theory
+		if(assigns[v]==l_True){
+			for(int g:var_groups[v]){
+				Group & group = groups[g];
+				group.n_true--;
+				if(group.true_var==v){
+					group.true_var=var_Undef;
+					if(group.n_true>0){
+						//another variable of this group is still true (this can only happen if there was a conflict,
+						//and the solver is backtracking out of order), so it must still be enforced
+						for(int i = group.begin;i<group.begin+group.size;i++){
+							if(members[i]!=v && assigns[members[i]]==l_True){
+								group.true_var=members[i];
+								break;
+							}
+						}
+						enqueueGroup(g);
+					}
+				}
+			}
+		}else{
+			for(int g:var_groups[v]){
+				groups[g].n_false--;
+				assert(groups[g].n_false>=0);
+			}
 		}
+		assigns[v]=l_Undef;
 	}
 	void enqueueTheory(Lit l) {
-		if(conflict_var==var_Undef){
-			if (!sign(l)){
-				if (true_var==var_Undef){
-					true_var=var(l);
-					assert(!needs_propagation);
+		Var v = var(l);
+		if(assigns[v]!=l_Undef){
+			//we already knew this lit was assigned, do nothing.
+			//(lits may be enqueued more than once, eg during the solver's initial propagation)
+			assert(assigns[v]==(sign(l)? l_False:l_True));
+			return;
+		}
+		assigns[v]= sign(l)? l_False:l_True;
+		if (!sign(l)){
+			for(int g:var_groups[v]){
+				Group & group = groups[g];
+				group.n_true++;
+				if (group.true_var==var_Undef){
+					group.true_var=v;
 					if(opt_amo_eager_prop){
 						//enqueue all of the remaining lits in the solver, now.
-						stats_propagations++;
-						for(Var v:amo){
-							if(v!=true_var){
-								S->enqueue(mkLit(v,true),assign_false_reason);
-							}
-						}
+						propagateGroup(g);
 					}else{
-						needs_propagation=true;
+						enqueueGroup(g);
+					}
+				}else if(conflict_clause.size()==0 || !isStillConflicting(conflict_clause)){
+					//there is a conflict - both v and true_var are assigned true, which is not allowed.
+					conflict_clause.clear();
+					conflict_clause.push(mkLit(v,true));
+					conflict_clause.push(mkLit(group.true_var,true));
+					S->needsPropagation(getTheoryIndex());
+				}
+			}
+		}else{
+			//it is always safe to assign a var to false (except in exactly-one groups).
+			for(int g:var_groups[v]){
+				Group & group = groups[g];
+				group.n_false++;
+				if(group.exactly_one && group.true_var==var_Undef && group.n_false>=group.size-1){
+					if(opt_amo_eager_prop && group.n_false<group.size){
+						propagateGroup(g);
+					}else{
+						enqueueGroup(g);
 					}
-				}else if (var(l)==true_var){
-					//we already knew this lit was assigned to true, do nothing.
-				}else{
-					//there is a conflict - both conflict_var and true_var are assigned true, which is not allowed.
-					conflict_var=var(l);
 				}
-			}else{
-				//it is always safe to assign a var to false.
 			}
 		}
 	}
 	;
 	bool propagateTheory(vec<Lit> & conflict) {
-		if(conflict_var!=var_Undef){
+		if(conflict_clause.size() && isStillConflicting(conflict_clause)){
 			conflict.clear();
-			assert(true_var!=var_Undef);
-			assert(true_var!=conflict_var);
-			conflict.push(mkLit(conflict_var,true));
-			conflict.push(mkLit(true_var,true));
-			needs_propagation=false;
+			conflict_clause.copyTo(conflict);
+			conflict_clause.clear();
 			stats_conflicts++;
 			return false;
-		}else if (true_var!=var_Undef && needs_propagation){
-			stats_propagations++;
-			needs_propagation=false;
-			assert(!opt_amo_eager_prop);
-			//enqueue all of the remaining lits in the solver, now.
-			for(Var v:amo){
-				if(v!=true_var){
-					S->enqueue(mkLit(v,true),assign_false_reason);
-				}
+		}
+		conflict_clause.clear();
+		while(propagation_queue.size()){
+			int g = propagation_queue.last();
+			propagation_queue.pop();
+			in_queue[g]=false;
+			if(!propagateGroup(g,conflict)){
+				stats_conflicts++;
+				return false;
 			}
 		}
 		return true;
 	}
 	void printStats(int detailLevel) {
 		printf("AMO Theory %d stats:\n", this->getTheoryIndex());
-
+		printf("Groups: %d\n",groups.size());
 		printf("Propagations: %ld (%f s, avg: %f s, %ld skipped)\n", stats_propagations, propagationtime,
 				(propagationtime) / ((double) stats_propagations + 1), stats_propagations_skipped);
 
@@ -169,33 +253,130 @@ public:
 	}
 	inline void buildReason(Lit p, vec<Lit> & reason, CRef reason_marker){
 		stats_reasons++;
-		assert(reason_marker==assign_false_reason);
-		if(var(p)!=true_var){
+		assert(S->value(p)==l_True);
+		Group & group = groups[reason_group[var(p)]];
+		if(reason_marker==assign_false_reason){
 			assert(sign(p));
-			assert(S->value(p)==l_True);
-			assert(S->value(true_var)==l_True);
-			reason.push(mkLit( var(p),true));
-			reason.push(mkLit(true_var,true));//either true_var (currently assigned true) must be false, or var(p) must be false
+			assert(group.true_var!=var_Undef);
+			assert(S->value(group.true_var)==l_True);
+			reason.push(p);
+			reason.push(mkLit(group.true_var,true));//either true_var (currently assigned true) must be false, or var(p) must be false
 		}else{
-			assert(false);
+			assert(reason_marker==assign_true_reason);
+			assert(!sign(p));
+			assert(group.exactly_one);
+			//all of the other variables in this exactly-one group are false
+			reason.push(p);
+			for(int i = group.begin;i<group.begin+group.size;i++){
+				Var v = members[i];
+				if(v!=var(p)){
+					assert(S->value(v)==l_False);
+					reason.push(mkLit(v));
+				}
+			}
 		}
 	}
 	bool check_solved() {
-		int n_true=0;
-		for (Var v:amo){
-			if(S->value(v)==l_True){
-				n_true+=1;
-				if(n_true>1){
-					return false;
+		for(Group & group:groups){
+			int n_true=0;
+			for(int i = group.begin;i<group.begin+group.size;i++){
+				if(S->value(members[i])==l_True){
+					n_true+=1;
 				}
 			}
+			if(n_true>1 || (group.exactly_one && n_true==0)){
+				return false;
+			}
 		}
-
 		return true;
 	}
 private:
 
-	
+	//Map a solver var into the var this theory uses for it (which is also a solver var).
+	Var toTheory(Var v){
+		replacement.growTo(v+1,var_Undef);
+		if(replacement[v]==var_Undef){
+			Var r = v;
+			if(S->hasTheory(v)){
+				//this var belongs to another theory; introduce an equivalent replacement variable
+				r = S->newVar();
+				S->addClause(~mkLit(v), mkLit(r));
+				S->addClause(mkLit(v), ~mkLit(r));
+			}
+			replacement[v]=r;
+			S->newTheoryVar(r, getTheoryIndex(),r);//using same variable indices in the theory as out of the theory
+			var_groups.growTo(r+1);
+			assigns.growTo(r+1,l_Undef);
+			reason_group.growTo(r+1,-1);
+		}
+		return replacement[v];
+	}
+
+	bool isStillConflicting(vec<Lit> & clause){
+		for(Lit l:clause){
+			if(S->value(l)!=l_False)
+				return false;
+		}
+		return true;
+	}
+
+	void enqueueGroup(int g){
+		if(!in_queue[g]){
+			in_queue[g]=true;
+			propagation_queue.push(g);
+		}
+		S->needsPropagation(getTheoryIndex());
+	}
+
+	void propagateGroup(int g){
+		vec<Lit> ignore;
+		if(!propagateGroup(g,ignore)){
+			//the conflict will be reported at the next call to propagateTheory
+			if(conflict_clause.size()==0 || !isStillConflicting(conflict_clause)){
+				ignore.copyTo(conflict_clause);
+				S->needsPropagation(getTheoryIndex());
+			}
+		}
+	}
+
+	bool propagateGroup(int g, vec<Lit> & conflict){
+		Group & group = groups[g];
+		if(group.true_var!=var_Undef){
+			stats_propagations++;
+			for(int i = group.begin;i<group.begin+group.size;i++){
+				Var v = members[i];
+				if(v!=group.true_var && S->value(v)==l_Undef){
+					reason_group[v]=g;
+					S->enqueue(mkLit(v,true),assign_false_reason);
+				}
+			}
+		}else if(group.exactly_one && group.n_false>=group.size-1){
+			Var unassigned=var_Undef;
+			for(int i = group.begin;i<group.begin+group.size;i++){
+				Var v = members[i];
+				if(assigns[v]!=l_False){
+					unassigned=v;
+					break;
+				}
+			}
+			if(unassigned==var_Undef){
+				//every variable in this exactly-one group is false
+				conflict.clear();
+				for(int i = group.begin;i<group.begin+group.size;i++){
+					conflict.push(mkLit(members[i]));
+				}
+				return false;
+			}else if(S->value(unassigned)==l_Undef){
+				stats_propagations++;
+				reason_group[unassigned]=g;
+				S->enqueue(mkLit(unassigned),assign_true_reason);
+			}else if (S->value(unassigned)==l_False){
+				//will be handled when the assignment is enqueued in the theory
+				stats_propagations_skipped++;
+			}
+		}
+		return true;
+	}
 };
 
 }
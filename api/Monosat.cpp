@@ -10,6 +10,7 @@
 #include "pb/PbTheory.h"
 #include "bv/BVTheorySolver.h"
 #include "amo/AMOTheory.h"
+#include "pb/WatchedPbTheory.h"
 #include "core/SolverTypes.h"
 #include "Monosat.h"
 #include "mtl/Vec.h"
@@ -18,6 +19,7 @@
 #include "graph/GraphParser.h"
 #include "utils/ParseUtils.h"
 #include "amo/AMOParser.h"
+#include "pb/WatchedPbParser.h"
 #include <stdexcept>
 #include <cstdarg>
 #include "core/Optimize.h"
@@ -236,6 +238,18 @@ void _selectAlgorithms(){
 				((string) opt_allpairs_alg).c_str());
 
 	}
+
+	decisionheuristic = DecisionHeuristic::VSIDS;
+	if (!strcasecmp(opt_decision_heuristic, "vsids")) {
+		decisionheuristic = DecisionHeuristic::VSIDS;
+	} else if (!strcasecmp(opt_decision_heuristic, "vmtf")) {
+		decisionheuristic = DecisionHeuristic::VMTF;
+	} else if (!strcasecmp(opt_decision_heuristic, "chb")) {
+		decisionheuristic = DecisionHeuristic::CHB;
+	} else {
+		api_errorf(  "Error: unknown decision heuristic %s, aborting\n", ((string) opt_decision_heuristic).c_str());
+
+	}
 }
 void printStats(SimpSolver* solver) {
 	double cpu_time = cpuTime();
@@ -250,8 +264,29 @@ void printStats(SimpSolver* solver) {
 struct MonosatData{
 	Monosat::BVTheorySolver<long> * bv_theory=nullptr;
 	vec< Monosat::GraphTheorySolver<long> *> graphs;
+	Monosat::WatchedPbTheory * pb_theory=nullptr;
+	Monosat::AMOTheory * amo_theory=nullptr;
+	std::string stats_json;
 };
 
+//All pseudo-boolean constraints in a solver share a single theory, which is created on demand
+static Monosat::WatchedPbTheory * getPBTheory(Monosat::SimpSolver * S){
+	MonosatData * d = (MonosatData*) S->_external_data;
+	if(!d->pb_theory){
+		d->pb_theory = new Monosat::WatchedPbTheory(S);
+	}
+	return d->pb_theory;
+}
+
+//All at-most-one constraints in a solver share a single theory, which is created on demand
+static Monosat::AMOTheory * getAMOTheory(Monosat::SimpSolver * S){
+	MonosatData * d = (MonosatData*) S->_external_data;
+	if(!d->amo_theory){
+		d->amo_theory = new Monosat::AMOTheory(S);
+	}
+	return d->amo_theory;
+}
+
 
 Monosat::SimpSolver * newSolver(){
 	return newSolver_arg(nullptr);
@@ -319,9 +354,13 @@ void readGNF(Monosat::SimpSolver * S, const char  * filename){
 	GraphParser<char *, SimpSolver> graphParser(precise,bvParser.theory);
 	parser.addParser(&graphParser);
 
-	AMOParser<char *, SimpSolver> amo;
+	MonosatData * d = (MonosatData*) S->_external_data;
+	AMOParser<char *, SimpSolver> amo(d->amo_theory);
 	parser.addParser(&amo);
 
+	WatchedPbParser<char *, SimpSolver> pb(d->pb_theory);
+	parser.addParser(&pb);
+
 	StreamBuffer strm(in);
 	vec<int> assumps;
 	bool ran_last_solve=false;
@@ -345,7 +384,8 @@ void readGNF(Monosat::SimpSolver * S, const char  * filename){
 
 
 	gzclose(in);
-
+	d->pb_theory = pb.getTheory();
+	d->amo_theory = amo.getTheory();
 }
 
 Monosat::GraphTheorySolver<int64_t> *  newGraph(Monosat::SimpSolver * S){
@@ -397,6 +437,13 @@ void setConflictLimit(Monosat::SimpSolver * S,int num_conflicts){
 void setPropagationLimit(Monosat::SimpSolver * S,int num_propagations){
 	S->setPropBudget(num_propagations);
 }
+const char * getStatsJSON(Monosat::SimpSolver * S){
+	MonosatData * d = (MonosatData*) S->_external_data;
+	std::stringstream ss;
+	S->writeStatsJSON(ss);
+	d->stats_json = ss.str();
+	return d->stats_json.c_str();
+}
 
 
 int solveLimited(Monosat::SimpSolver * S){
@@ -761,12 +808,50 @@ void bv_slice( Monosat::SimpSolver * S, Monosat::BVTheorySolver<long> * bv,int a
  //for small numbers of variables, consider using a direct CNF encoding instead
  void at_most_one(Monosat::SimpSolver * S, int * vars, int n_vars){
 	 if(n_vars>1){
-		 AMOTheory* amo = new  AMOTheory(S);
+		 vec<Var> amo;
 		 for(int i = 0;i<n_vars;i++){
-			 Var v = vars[i];
-			 amo->addVar(v);
+			 amo.push(vars[i]);
 		 }
+		 getAMOTheory(S)->addGroup(amo);
+	 }
+ }
+ //asserts that exactly one of the set of variables (NOT LITERALS) must be true.
+ void exactly_one(Monosat::SimpSolver * S, int * vars, int n_vars){
+	 vec<Var> group;
+	 for(int i = 0;i<n_vars;i++){
+		 group.push(vars[i]);
 	 }
+	 getAMOTheory(S)->addGroup(group,true);
+ }
+
+ //pseudo-boolean constraints: asserts that sum(coefficients[i]*literals[i]) op rhs.
+ //coefficients may be negative; if coefficients is null, each coefficient is 1.
+ static void assertPB(Monosat::SimpSolver * S, int rhs, int n_args, int * literals, int * coefficients, WatchedPbTheory::PbType op){
+	 vec<Lit> lits;
+	 vec<int64_t> weights;
+	 for(int i = 0;i<n_args;i++){
+		 Lit l = toLit(literals[i]);
+		 if(var(l)>=S->nVars())
+			 api_errorf("Bad literal %d in pb constraint",literals[i]);
+		 lits.push(l);
+		 weights.push(coefficients ? coefficients[i] : 1);
+	 }
+	 getPBTheory(S)->addConstraint(lits,weights,rhs,op);
+ }
+ void assertPB_lt(Monosat::SimpSolver * S, int rhs, int n_args, int * literals, int * coefficients){
+	 assertPB(S,rhs,n_args,literals,coefficients,WatchedPbTheory::PbType::LT);
+ }
+ void assertPB_leq(Monosat::SimpSolver * S, int rhs, int n_args, int * literals, int * coefficients){
+	 assertPB(S,rhs,n_args,literals,coefficients,WatchedPbTheory::PbType::LE);
+ }
+ void assertPB_eq(Monosat::SimpSolver * S, int rhs, int n_args, int * literals, int * coefficients){
+	 assertPB(S,rhs,n_args,literals,coefficients,WatchedPbTheory::PbType::EQ);
+ }
+ void assertPB_geq(Monosat::SimpSolver * S, int rhs, int n_args, int * literals, int * coefficients){
+	 assertPB(S,rhs,n_args,literals,coefficients,WatchedPbTheory::PbType::GE);
+ }
+ void assertPB_gt(Monosat::SimpSolver * S, int rhs, int n_args, int * literals, int * coefficients){
+	 assertPB(S,rhs,n_args,literals,coefficients,WatchedPbTheory::PbType::GT);
  }
 
  //theory interface for graphs
@@ -60,6 +60,10 @@ typedef int Var;
   //Sets the maximum number of (additional) propagations allowed in the solver before returning l_Undef from solveLimited; ignored by solve(). Set to <0 to disable propagation limit.
   void setPropagationLimit(SolverPtr S,int num_propagations);
 
+  //Returns a snapshot of the solver's (and each theory's) statistics, as a JSON object.
+  //May be called while another thread is solving. The returned string is owned by the solver, and is valid until the next call.
+  const char * getStatsJSON(SolverPtr S);
+
   //Returns 0 for satisfiable, 1 for proved unsatisfiable, 2 for failed to find a solution (within any resource limits that have been set)
   int solveLimited(SolverPtr S);
   //Returns 0 for satisfiable, 1 for proved unsatisfiable, 2 for failed to find a solution (within any resource limits that have been set)
@@ -135,6 +139,16 @@ typedef int Var;
   //simple at-most-one constraint: asserts that at most one of the set of variables (NOT LITERALS) may be true.
   //for small numbers of variables, consider using a direct CNF encoding instead
   void at_most_one(SolverPtr S, int * vars, int n_vars);
+  //asserts that exactly one of the set of variables (NOT LITERALS) must be true.
+  void exactly_one(SolverPtr S, int * vars, int n_vars);
+
+  //pseudo-boolean constraints: assert that sum(coefficients[i]*literals[i]) op rhs.
+  //coefficients may be negative; if coefficients is null, all coefficients are 1.
+  void assertPB_lt(SolverPtr S, int rhs, int n_args, int * literals, int * coefficients);
+  void assertPB_leq(SolverPtr S, int rhs, int n_args, int * literals, int * coefficients);
+  void assertPB_eq(SolverPtr S, int rhs, int n_args, int * literals, int * coefficients);
+  void assertPB_geq(SolverPtr S, int rhs, int n_args, int * literals, int * coefficients);
+  void assertPB_gt(SolverPtr S, int rhs, int n_args, int * literals, int * coefficients);
 
   //theory interface for graphs
 
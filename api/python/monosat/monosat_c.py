@@ -135,6 +135,9 @@ class Monosat(metaclass=Singleton):
         self.monosat_c.setMemoryLimit.argtypes=[c_solver_p,c_int]
         self.monosat_c.setConflictLimit.argtypes=[c_solver_p,c_int]
         self.monosat_c.setPropagationLimit.argtypes=[c_solver_p,c_int]    
+
+        self.monosat_c.getStatsJSON.argtypes=[c_solver_p]
+        self.monosat_c.getStatsJSON.restype=c_char_p
         
         self.monosat_c.backtrack.argtypes=[c_solver_p]
         
@@ -176,6 +179,13 @@ class Monosat(metaclass=Singleton):
         self.monosat_c.true_lit.restype=c_int 
         
         self.monosat_c.at_most_one.argtypes=[c_solver_p,c_var_p,c_int]
+        self.monosat_c.exactly_one.argtypes=[c_solver_p,c_var_p,c_int]
+
+        self.monosat_c.assertPB_lt.argtypes=[c_solver_p,c_int,c_int,c_literal_p,c_int_p]
+        self.monosat_c.assertPB_leq.argtypes=[c_solver_p,c_int,c_int,c_literal_p,c_int_p]
+        self.monosat_c.assertPB_eq.argtypes=[c_solver_p,c_int,c_int,c_literal_p,c_int_p]
+        self.monosat_c.assertPB_geq.argtypes=[c_solver_p,c_int,c_int,c_literal_p,c_int_p]
+        self.monosat_c.assertPB_gt.argtypes=[c_solver_p,c_int,c_int,c_literal_p,c_int_p]
 
         
         self.monosat_c.initBVTheory.argtypes=[c_solver_p];
@@ -402,6 +412,9 @@ class Monosat(metaclass=Singleton):
         else:
             self.monosat_c.setPropagationLimit(self.solver._ptr,propagations)
 
+    def getStatsJSON(self):
+        return self.monosat_c.getStatsJSON(self.solver._ptr).decode('utf-8')
+
 
 
     def solve(self,assumptions=None,minimize_bvs=None):
@@ -569,6 +582,21 @@ class Monosat(metaclass=Singleton):
        
     def AssertAtMostOne(self,clause):
         self.backtrack()     
+        newclause = self._positiveLits(clause)
+        if self.solver.output:
+            self._echoOutput("amo " + " ".join((str(dimacs(c)) for c in newclause))+" 0\n")
+        lp = self._varArray(newclause)
+        self.monosat_c.at_most_one(self.solver._ptr,lp,len(newclause))  
+
+    def AssertExactlyOne(self,clause):
+        self.backtrack()
+        newclause = self._positiveLits(clause)
+        if self.solver.output:
+            self._echoOutput("exactly_one " + " ".join((str(dimacs(c)) for c in newclause))+" 0\n")
+        lp = self._varArray(newclause)
+        self.monosat_c.exactly_one(self.solver._ptr,lp,len(newclause))
+
+    def _positiveLits(self,clause):
         newclause=[]
         for l in clause:
             if self.isPositive(l):
@@ -579,17 +607,38 @@ class Monosat(metaclass=Singleton):
                 self.addBinaryClause(self.Not(l), l2)
                 self.addBinaryClause(self.Not(l2), l)
                 newclause.append(l2)
-                
-        if self.solver.output:
-            self._echoOutput("amo " + " ".join((str(dimacs(c)) for c in newclause))+" 0\n")
+        return newclause
+
+    def _varArray(self,newclause):
         lp = self.getIntArray(newclause)        
         for i in range(len(newclause)):
             l = lp[i]
             assert(self.isPositive(l))
             assert(l%2==0)#all of the literals must be positive
             lp[i]=l//2
+        return lp
 
-        self.monosat_c.at_most_one(self.solver._ptr,lp,len(newclause))  
+    #Assert the pseudo-boolean constraint sum(weights[i]*lits[i]) op rhs, where op is one of '<','<=','=','>=','>'
+    def AssertPB(self,lits,weights,op,rhs):
+        self.backtrack()
+        if op=='<':
+            f = self.monosat_c.assertPB_lt
+        elif op=='<=':
+            f = self.monosat_c.assertPB_leq
+        elif op=='=' or op=='==':
+            op='='
+            f = self.monosat_c.assertPB_eq
+        elif op=='>=':
+            f = self.monosat_c.assertPB_geq
+        elif op=='>':
+            f = self.monosat_c.assertPB_gt
+        else:
+            raise Exception("Unknown operator " + op)
+        if self.solver.output:
+            self._echoOutput("pb %d "%(len(lits)) + " ".join((str(dimacs(l)) for l in lits)) + " %d "%(len(weights)) + " ".join((str(w) for w in weights)) + " %s %d\n"%(op,rhs))
+        lp = self.getIntArray(lits)
+        wp = (c_int * len(weights))(*weights)
+        f(self.solver._ptr,rhs,len(lits),lp,wp)
     
     #def preprocess(self,disable_future_preprocessing=False):
     #    self.monosat_c.preprocess(disable_future_preprocessing)
@@ -38,7 +38,7 @@ class PBManager(metaclass=Manager):
         self.pb = pb
     
     def  __init__(self):
-        self.pb = MinisatPlus()
+        self.pb = MonosatTheoryPB()
         self.import_time=0
         self.elapsed_time=0
     
@@ -118,8 +118,14 @@ class PBManager(metaclass=Manager):
         Monosat().AssertAtMostOne([l.getLit() for l in new_clause])
         
     def AssertExactlyOne(self,clause):
-        AssertClause(clause)
-        self.AssertAtMostOne(clause)
+        new_clause=[]
+        #create fresh variables, so that theory vars can be used as arguments here.
+        for l in clause:
+            l2 = Var()
+            new_clause.append(l2)
+            AssertEq(l2,l)    
+ 
+        Monosat().AssertExactlyOne([l.getLit() for l in new_clause])
     
     def hasConstraints(self):
         return self.pb.hasConstraints();
@@ -732,6 +738,45 @@ class MinisatPlus:
         os.remove(tmpcnf)
         PBManager().import_time+=time.clock()-t;
         print("Imported pseudoboolean constraints into Monosat (%d clauses)"%(n_cls))
+#Enforces pb constraints directly, using MonoSAT's built-in pseudo-boolean theory solver (no external tools are required).
+class MonosatTheoryPB(MinisatPlus):
+    def  __init__(self):
+        super().__init__()
+
+    def AssertPB(self,clause,val,constraint,weights=None):
+        if(constraint=='!=' or constraint=='<>'):
+            self.AssertNotEqualPB(clause,val,weights);
+            return
+        if(not isinstance(val, int)):
+            raise TypeError("PB constraints weights must compare to integers, but found " + str(type(val)))
+        lits=[]
+        nweights=[]
+        for i,l in enumerate(clause):
+            if weights is not None and i<len(weights):
+                w = weights[i]
+            else:
+                w=1
+            if w==0:
+                continue
+            if l.isConstTrue():
+                val-=w
+                continue
+            elif l.isConstFalse():
+                continue
+            lits.append(l.getLit())
+            nweights.append(w)
+        if len(lits)==0:
+            if not ((constraint=='<' and 0<val) or (constraint=='<=' and 0<=val) or ((constraint=='=' or constraint=='==') and 0==val) or (constraint=='>=' and 0>=val) or (constraint=='>' and 0>val)):
+                Assert(false())
+            return
+        Monosat().AssertPB(lits,nweights,constraint,val)
+
+    def hasConstraints(self):
+        return False
+
+    def write(self):
+        pass
+
 class PBSugar:
     def  __init__(self):
         self.constraints=[]
@@ -0,0 +1,359 @@
+/****************************************************************************************[DGLBench.cpp]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+//Micro-benchmark for the dynamic graph algorithms in dgl/, in isolation from the solver.
+//Replays a DynamicGraph log (as written by 'monosat -debug-log=<dir>', to <dir>/LOG_GRAPH_UNDER<n> and
+//<dir>/LOG_GRAPH_OVER<n>) against each selected algorithm, updating the algorithm after every -batch edge
+//enables/disables, and reports the latency distribution of those updates.
+//
+//Usage: dglbench [-algs=bfs,dijkstra,...] [-source=<node>] [-sink=<node>] [-batch=<n>] [-json] <log file>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "utils/Options.h"
+#include "utils/Profile.h"
+#include "dgl/DynamicGraph.h"
+#include "dgl/BFS.h"
+#include "dgl/DFS.h"
+#include "dgl/Dijkstra.h"
+#include "dgl/RamalReps.h"
+#include "dgl/Dinics.h"
+#include "dgl/KohliTorr.h"
+#include "dgl/SpiraPan.h"
+#include "dgl/Kruskal.h"
+#include "dgl/Prim.h"
+#include "dgl/ThorupDynamicConnectivity.h"
+#include "dgl/PKTopologicalSort.h"
+
+using namespace Monosat;
+using namespace dgl;
+
+static const char* _cat_bench = "DGLBENCH";
+static StringOption opt_bench_algs(_cat_bench, "algs",
+		"Comma-separated algorithms to replay the log against (bfs,dfs,dijkstra,ramal-reps,dinitz,kohli-torr,spira-pan,kruskal,prim,thorup,pk), or 'all'",
+		"all");
+static IntOption opt_bench_source(_cat_bench, "source", "Source node for reachability, distance and flow algorithms", 0,
+		IntRange(0, INT32_MAX));
+static IntOption opt_bench_sink(_cat_bench, "sink", "Sink node for flow algorithms (-1 for the last node)", -1,
+		IntRange(-1, INT32_MAX));
+static IntOption opt_bench_batch(_cat_bench, "batch", "Number of edge enables/disables between algorithm updates", 1,
+		IntRange(1, INT32_MAX));
+static BoolOption opt_bench_json(_cat_bench, "json", "Print one JSON object per algorithm, instead of a table", false);
+
+typedef long Weight;
+
+//One line of the log
+struct Op {
+	enum Type {
+		NODE, EDGE, WEIGHT, ENABLE, DISABLE, CLEAR_HISTORY, INVALIDATE
+	} type;
+	int from;
+	int to;
+	int edgeID;
+	Weight weight;
+};
+
+static bool readLog(const char * filename, std::vector<Op> & ops) {
+	FILE * f = fopen(filename, "r");
+	if (!f)
+		return false;
+	char line[4096];
+	while (fgets(line, sizeof(line), f)) {
+		Op op = { Op::NODE, -1, -1, -1, 0 };
+		char * s = line;
+		while (*s == ' ' || *s == '\t')
+			s++;
+		if (*s == '\n' || *s == '\0') {
+			continue;
+		} else if (!strncmp(s, "node", 4)) {
+			op.type = Op::NODE;
+		} else if (!strncmp(s, "edge_weight", 11)) {
+			//the solver logs weights as integers for int graphs; weights of other types are truncated
+			op.type = Op::WEIGHT;
+			char * end;
+			op.edgeID = strtol(s + 11, &end, 10) - 1;
+			op.weight = (Weight) strtod(end, nullptr);
+		} else if (!strncmp(s, "edge_bv_weight", 14) || !strncmp(s, "enqueue", 7)) {
+			continue;
+		} else if (!strncmp(s, "edge", 4)) {
+			int unused;
+			op.type = Op::EDGE;
+			if (sscanf(s + 4, "%d %d %d %d", &op.from, &op.to, &unused, &op.edgeID) != 4) {
+				fprintf(stderr, "Bad edge in log: %s", line);
+				exit(1);
+			}
+			op.edgeID--;
+		} else if (!strncmp(s, "clearHistory", 12)) {
+			op.type = Op::CLEAR_HISTORY;
+		} else if (!strncmp(s, "invalidate", 10)) {
+			op.type = Op::INVALIDATE;
+		} else if (*s == '-' || (*s >= '0' && *s <= '9')) {
+			int id = atoi(s);
+			op.type = id > 0 ? Op::ENABLE : Op::DISABLE;
+			op.edgeID = abs(id) - 1;
+		} else {
+			continue;
+		}
+		ops.push_back(op);
+	}
+	fclose(f);
+	return true;
+}
+
+static void apply(DynamicGraph<Weight> & g, const Op & op) {
+	switch (op.type) {
+	case Op::NODE:
+		g.addNode();
+		break;
+	case Op::EDGE:
+		g.addEdge(op.from, op.to, op.edgeID);
+		break;
+	case Op::WEIGHT:
+		g.setEdgeWeight(op.edgeID, op.weight);
+		break;
+	case Op::ENABLE:
+		g.enableEdge(op.edgeID);
+		break;
+	case Op::DISABLE:
+		g.disableEdge(op.edgeID);
+		break;
+	case Op::CLEAR_HISTORY:
+		g.clearHistory(true);
+		break;
+	case Op::INVALIDATE:
+		g.invalidate();
+		break;
+	}
+}
+
+//Type-erased handle on an algorithm, which owns it and knows how to update it
+struct Algorithm {
+	std::shared_ptr<void> owner;
+	std::function<void()> update;
+	//Optional; sees each edge enable/disable as it is applied to the graph (for structures that don't read the graph's history)
+	std::function<void(const Op&)> observe;
+};
+
+//ThorupDynamicConnectivity maintains its own copy of the graph, rather than reading it from a DynamicGraph,
+//so this queues up the enables and disables since the last update, and applies them in update().
+struct ThorupAdapter {
+	DynamicGraph<Weight> & g;
+	ThorupDynamicConnectivity t;
+	std::vector<Op> pending;
+	int source;
+	int sink;
+	ThorupAdapter(DynamicGraph<Weight> & g, int source, int sink) :
+			g(g), source(source), sink(sink) {
+		for (int i = 0; i < g.nodes(); i++)
+			t.addNode();
+		for (int i = 0; i < g.edges(); i++) {
+			if (g.hasEdge(i)) {
+				t.addEdge(g.getEdge(i).from, g.getEdge(i).to, i);
+				if (g.edgeEnabled(i))
+					t.setEdgeEnabled(g.getEdge(i).from, g.getEdge(i).to, i, true);
+			}
+		}
+	}
+	void update() {
+		for (const Op & op : pending) {
+			auto & e = g.getEdge(op.edgeID);
+			t.setEdgeEnabled(e.from, e.to, op.edgeID, op.type == Op::ENABLE);
+		}
+		pending.clear();
+		t.connected(source, sink);
+	}
+};
+
+template<class T>
+static Algorithm wrap(T * alg) {
+	Algorithm a;
+	a.owner = std::shared_ptr<void>(alg, [](void * p) {delete (T*) p;});
+	a.update = [alg]() {alg->update();};
+	return a;
+}
+
+static bool makeAlgorithm(const std::string & name, DynamicGraph<Weight> & g, int source, int sink, Algorithm & alg) {
+	if (name == "bfs") {
+		alg = wrap(new BFSReachability<Weight>(source, g));
+	} else if (name == "dfs") {
+		auto * r = new DFSReachability<Weight>(g);
+		r->setSource(source);
+		alg = wrap(r);
+	} else if (name == "dijkstra") {
+		alg = wrap(new Dijkstra<Weight>(source, g));
+	} else if (name == "ramal-reps") {
+		alg = wrap(new RamalReps<Weight>(source, g, Distance<Weight>::nullStatus));
+	} else if (name == "dinitz") {
+		alg = wrap(new Dinitz<Weight>(g, source, sink));
+	} else if (name == "kohli-torr") {
+		alg = wrap(new KohliTorr<Weight>(g, source, sink));
+	} else if (name == "spira-pan") {
+		alg = wrap(
+				new SpiraPan<typename MinimumSpanningTree<Weight>::NullStatus, Weight>(g,
+						MinimumSpanningTree<Weight>::nullStatus));
+	} else if (name == "kruskal") {
+		alg = wrap(
+				new Kruskal<typename MinimumSpanningTree<Weight>::NullStatus, Weight>(g,
+						MinimumSpanningTree<Weight>::nullStatus));
+	} else if (name == "prim") {
+		alg = wrap(
+				new Prim<typename MinimumSpanningTree<Weight>::NullStatus, Weight>(g,
+						MinimumSpanningTree<Weight>::nullStatus));
+	} else if (name == "thorup") {
+		auto * r = new ThorupAdapter(g, source, sink);
+		alg = wrap(r);
+		alg.observe = [r](const Op & op) {
+			if (op.type == Op::ENABLE || op.type == Op::DISABLE)
+				r->pending.push_back(op);
+		};
+	} else if (name == "pk") {
+		alg = wrap(new PKToplogicalSort<Weight>(g));
+	} else {
+		return false;
+	}
+	return true;
+}
+
+struct Result {
+	std::string name;
+	double initial_seconds = 0;
+	double total_seconds = 0;
+	std::vector<uint64_t> latencies; //in cycles
+	double percentile(double p) {
+		if (latencies.size() == 0)
+			return 0;
+		size_t i = std::min(latencies.size() - 1, (size_t) (p * latencies.size()));
+		return latencies[i] * secondsPerCycle() * 1e6;
+	}
+};
+
+//Replay the log against a single algorithm. The graph is constructed first (everything up to the last node or edge
+//declaration in the log); the algorithm then sees only the enables/disables (and weight changes) that follow.
+static Result replay(const std::string & name, const std::vector<Op> & ops) {
+	Result r;
+	r.name = name;
+	size_t setup_end = 0;
+	for (size_t i = 0; i < ops.size(); i++) {
+		if (ops[i].type == Op::NODE || ops[i].type == Op::EDGE)
+			setup_end = i + 1;
+	}
+	//weights immediately following the last edge declaration belong to the setup
+	while (setup_end < ops.size() && ops[setup_end].type == Op::WEIGHT)
+		setup_end++;
+
+	DynamicGraph<Weight> g;
+	for (size_t i = 0; i < setup_end; i++)
+		apply(g, ops[i]);
+	g.clearHistory(true);
+
+	int source = std::min((int) opt_bench_source, std::max(0, g.nodes() - 1));
+	int sink = opt_bench_sink >= 0 ? std::min((int) opt_bench_sink, g.nodes() - 1) : g.nodes() - 1;
+	Algorithm alg;
+	if (!makeAlgorithm(name, g, source, sink, alg)) {
+		fprintf(stderr, "Unknown algorithm %s\n", name.c_str());
+		exit(1);
+	}
+
+	uint64_t start = cycleCount();
+	alg.update();
+	r.initial_seconds = (cycleCount() - start) * secondsPerCycle();
+
+	int pending = 0;
+	for (size_t i = setup_end; i < ops.size(); i++) {
+		apply(g, ops[i]);
+		if (alg.observe)
+			alg.observe(ops[i]);
+		if (ops[i].type == Op::ENABLE || ops[i].type == Op::DISABLE || ops[i].type == Op::WEIGHT) {
+			if (++pending >= opt_bench_batch) {
+				pending = 0;
+				uint64_t t = cycleCount();
+				alg.update();
+				r.latencies.push_back(cycleCount() - t);
+			}
+		}
+	}
+	if (pending > 0) {
+		uint64_t t = cycleCount();
+		alg.update();
+		r.latencies.push_back(cycleCount() - t);
+	}
+	uint64_t total = 0;
+	for (uint64_t l : r.latencies)
+		total += l;
+	r.total_seconds = total * secondsPerCycle();
+	std::sort(r.latencies.begin(), r.latencies.end());
+	return r;
+}
+
+int main(int argc, char** argv) {
+	setUsageHelp("USAGE: %s [options] <DynamicGraph log file>\n\n");
+	parseOptions(argc, argv, true);
+	if (argc != 2) {
+		fprintf(stderr, "USAGE: %s [options] <DynamicGraph log file>\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<Op> ops;
+	if (!readLog(argv[1], ops)) {
+		fprintf(stderr, "Could not open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<std::string> algs;
+	std::string alg_list = (const char*) opt_bench_algs;
+	if (alg_list == "all")
+		alg_list = "bfs,dfs,dijkstra,ramal-reps,dinitz,kohli-torr,spira-pan,kruskal,prim,thorup,pk";
+	std::stringstream ss(alg_list);
+	std::string name;
+	while (std::getline(ss, name, ',')) {
+		if (name.size())
+			algs.push_back(name);
+	}
+
+	if (!opt_bench_json) {
+		printf("%-12s %10s %12s %12s %10s %10s %10s %10s %10s\n", "algorithm", "updates", "initial(us)", "total(s)",
+				"mean(us)", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+	}
+	for (const std::string & a : algs) {
+		Result r = replay(a, ops);
+		double mean = r.latencies.size() ? r.total_seconds * 1e6 / r.latencies.size() : 0;
+		if (opt_bench_json) {
+			printf("{\"algorithm\":\"%s\",\"log\":\"%s\",\"batch\":%d,\"updates\":%zu,\"initial_us\":%f,\"total_s\":%f,"
+					"\"mean_us\":%f,\"p50_us\":%f,\"p90_us\":%f,\"p99_us\":%f,\"p999_us\":%f,\"max_us\":%f}\n",
+					r.name.c_str(), argv[1], (int) opt_bench_batch, r.latencies.size(), r.initial_seconds * 1e6,
+					r.total_seconds, mean, r.percentile(0.5), r.percentile(0.9), r.percentile(0.99), r.percentile(0.999),
+					r.percentile(1.0));
+		} else {
+			printf("%-12s %10zu %12.1f %12.4f %10.2f %10.2f %10.2f %10.2f %10.2f\n", r.name.c_str(), r.latencies.size(),
+					r.initial_seconds * 1e6, r.total_seconds, mean, r.percentile(0.5), r.percentile(0.9),
+					r.percentile(0.99), r.percentile(1.0));
+		}
+		fflush(stdout);
+	}
+	return 0;
+}
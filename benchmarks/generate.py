@@ -0,0 +1,333 @@
+#!/usr/bin/env python3
+#The MIT License (MIT)
+#
+#Copyright (c) 2014, Sam Bayless
+#
+#Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+#associated documentation files (the "Software"), to deal in the Software without restriction,
+#including without limitation the rights to use, copy, modify, merge, publish, distribute,
+#sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+#furnished to do so, subject to the following conditions:
+#
+#The above copyright notice and this permission notice shall be included in all copies or
+#substantial portions of the Software.
+#
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+#NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+#NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+#DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+#OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#Generates reproducible families of GNF instances, one family per theory.
+#Every instance is fully determined by its (family, size, seed), so benchmark results from different
+#builds (or different algorithm options) can be compared instance by instance.
+
+import argparse
+import os
+import random
+
+
+class GNF():
+    def __init__(self):
+        self.nvars = 0
+        self.clauses = []
+        self.lines = []
+
+    def newVar(self):
+        self.nvars += 1
+        return self.nvars
+
+    def addClause(self, *lits):
+        self.clauses.append(lits)
+
+    def add(self, line):
+        self.lines.append(line)
+
+    def write(self, f):
+        f.write("p cnf %d %d\n" % (self.nvars, len(self.clauses)))
+        for c in self.clauses:
+            f.write(" ".join(str(l) for l in c) + " 0\n")
+        for line in self.lines:
+            f.write(line + "\n")
+
+
+def grid(gnf, gid, n, rnd, weighted=False, max_weight=9):
+    #an n*n grid with edges in both directions between neighbouring cells
+    nodes = n * n
+    edges = []
+    for y in range(n):
+        for x in range(n):
+            u = y * n + x
+            if x + 1 < n:
+                edges.append((u, u + 1))
+                edges.append((u + 1, u))
+            if y + 1 < n:
+                edges.append((u, u + n))
+                edges.append((u + n, u))
+    gnf.add("digraph int %d %d %d" % (nodes, len(edges), gid))
+    evars = []
+    for (u, v) in edges:
+        e = gnf.newVar()
+        evars.append(e)
+        if weighted:
+            gnf.add("edge %d %d %d %d %d" % (gid, u, v, e, rnd.randint(1, max_weight)))
+        else:
+            gnf.add("edge %d %d %d %d" % (gid, u, v, e))
+    return edges, evars
+
+
+def random_graph(gnf, gid, nodes, nedges, rnd, max_weight=9):
+    edges = []
+    seen = set()
+    while len(edges) < nedges:
+        u = rnd.randrange(nodes)
+        v = rnd.randrange(nodes)
+        if u == v or (u, v) in seen:
+            continue
+        seen.add((u, v))
+        edges.append((u, v))
+    gnf.add("digraph int %d %d %d" % (nodes, len(edges), gid))
+    evars = []
+    for (u, v) in edges:
+        e = gnf.newVar()
+        evars.append(e)
+        gnf.add("edge %d %d %d %d %d" % (gid, u, v, e, rnd.randint(1, max_weight)))
+    return edges, evars
+
+
+def exclusions(gnf, evars, n, rnd):
+    #random pairwise exclusions between edges, so that the solver has to search over the edge assignment
+    for i in range(n):
+        a, b = rnd.sample(evars, 2)
+        gnf.addClause(-a, -b)
+
+
+def gen_reach(n, rnd):
+    gnf = GNF()
+    edges, evars = grid(gnf, 0, n, rnd)
+    exclusions(gnf, evars, len(evars) // 4, rnd)
+    last = n * n - 1
+    for (s, t) in [(0, last), (n - 1, last - (n - 1))]:
+        r = gnf.newVar()
+        gnf.add("reach 0 %d %d %d" % (s, t, r))
+        gnf.addClause(r)
+    #some cells must be cut off from the source
+    for i in range(max(1, n // 3)):
+        u = rnd.randrange(1, last)
+        r = gnf.newVar()
+        gnf.add("reach 0 0 %d %d" % (u, r))
+        gnf.addClause(-r)
+    return gnf
+
+
+def gen_distance(n, rnd):
+    gnf = GNF()
+    edges, evars = grid(gnf, 0, n, rnd, weighted=True)
+    exclusions(gnf, evars, len(evars) // 3, rnd)
+    last = n * n - 1
+    d = gnf.newVar()
+    gnf.add("weighted_distance_leq 0 0 %d %d %d" % (last, d, 4 * 2 * (n - 1)))
+    gnf.addClause(d)
+    #the unweighted path between the other two corners must be long
+    d2 = gnf.newVar()
+    gnf.add("distance_leq 0 %d %d %d %d" % (n - 1, last - (n - 1), d2, 2 * (n - 1) + 2))
+    gnf.addClause(-d2)
+    r = gnf.newVar()
+    gnf.add("reach 0 %d %d %d" % (n - 1, last - (n - 1), r))
+    gnf.addClause(r)
+    return gnf
+
+
+def gen_maxflow(n, rnd):
+    gnf = GNF()
+    edges, evars = grid(gnf, 0, n, rnd, weighted=True, max_weight=5)
+    exclusions(gnf, evars, len(evars) // 3, rnd)
+    f = gnf.newVar()
+    gnf.add("maximum_flow_geq 0 0 %d %d %d" % (n * n - 1, f, 3))
+    gnf.addClause(f)
+    f2 = gnf.newVar()
+    gnf.add("maximum_flow_geq 0 %d %d %d %d" % (n - 1, n * (n - 1), f2, 4))
+    gnf.addClause(-f2)
+    return gnf
+
+
+def gen_mst(n, rnd):
+    gnf = GNF()
+    nodes = n * 2
+    edges, evars = random_graph(gnf, 0, nodes, nodes * 4, rnd)
+    exclusions(gnf, evars, len(evars) // 2, rnd)
+    m = gnf.newVar()
+    gnf.add("mst_weight_leq 0 %d %d" % (m, nodes * 3))
+    gnf.addClause(m)
+    return gnf
+
+
+def gen_acyclic(n, rnd):
+    gnf = GNF()
+    nodes = n * 2
+    edges, evars = random_graph(gnf, 0, nodes, nodes * 4, rnd)
+    #every node has at least two outgoing edges, except for a few sinks
+    out = {}
+    for (e, v) in zip(edges, evars):
+        out.setdefault(e[0], []).append(v)
+    sinks = set(rnd.sample(range(nodes), max(1, nodes // 4)))
+    for u, vs in out.items():
+        if u not in sinks and len(vs) >= 2:
+            for i in range(len(vs)):
+                #at least two of vs: every subset of size len(vs)-1 must contain an enabled edge
+                gnf.addClause(*(vs[:i] + vs[i + 1:]))
+    exclusions(gnf, evars, len(evars) // 4, rnd)
+    a = gnf.newVar()
+    gnf.add("acyclic 0 %d" % (a))
+    gnf.addClause(a)
+    return gnf
+
+
+def gen_bv(n, rnd):
+    gnf = GNF()
+    #all operands of an addition must have the same width
+    width = 12
+    nbvs = n
+    bvid = 0
+    args = []
+    for i in range(nbvs):
+        bits = [gnf.newVar() for b in range(width)]
+        gnf.add("bv %d %d %s" % (bvid, width, " ".join(str(b) for b in bits)))
+        args.append((bvid, bits))
+        c = gnf.newVar()
+        gnf.add("bv const <= %d %d %d" % (c, bvid, 100))
+        gnf.addClause(c)
+        bvid += 1
+    #a chain of partial sums
+    total = args[0][0]
+    for i in range(1, nbvs):
+        s = bvid
+        bvid += 1
+        gnf.add("bv anon %d %d" % (s, width))
+        gnf.add("bv + %d %d %d" % (s, total, args[i][0]))
+        total = s
+    c = gnf.newVar()
+    gnf.add("bv const >= %d %d %d" % (c, total, nbvs * 50))
+    gnf.addClause(c)
+    c = gnf.newVar()
+    gnf.add("bv const <= %d %d %d" % (c, total, nbvs * 50 + 1))
+    gnf.addClause(c)
+    #pairwise orderings between the arguments, and a few clauses over their bits
+    for i in range(nbvs - 1):
+        c = gnf.newVar()
+        gnf.add("bv < %d %d %d" % (c, args[i][0], args[i + 1][0]))
+        gnf.addClause(c)
+    for i in range(nbvs * 2):
+        (_, a), (_, b) = rnd.sample(args, 2)
+        gnf.addClause(-rnd.choice(a), -rnd.choice(b))
+    return gnf
+
+
+def gen_fsm(n, rnd):
+    gnf = GNF()
+    states = max(3, n // 2)
+    labels = 2
+    gnf.add("fsm 0 %d 0" % (labels + 1))
+    trans = []
+    for u in range(states):
+        for v in range(states):
+            for l in range(1, labels + 1):
+                t = gnf.newVar()
+                trans.append((u, l, t))
+                gnf.add("transition 0 %d %d %d 0 %d" % (u, v, l, t))
+    #the synthesized machine must be deterministic
+    by_label = {}
+    for (u, l, t) in trans:
+        by_label.setdefault((u, l), []).append(t)
+    for ts in by_label.values():
+        for i in range(len(ts)):
+            for j in range(i + 1, len(ts)):
+                gnf.addClause(-ts[i], -ts[j])
+    #accept strings with an even number of 1s (a language the machine can represent), and reject the others
+    strings = []
+    for i in range(n):
+        s = [rnd.randint(1, labels) for j in range(rnd.randint(1, n))]
+        strings.append(s)
+    for (i, s) in enumerate(strings):
+        gnf.add("str %d %s" % (i, " ".join(str(l) for l in s)))
+    for (i, s) in enumerate(strings):
+        a = gnf.newVar()
+        gnf.add("accepts 0 0 %d %d %d" % (states - 1, i, a))
+        gnf.addClause(a if s.count(1) % 2 == 0 else -a)
+    return gnf
+
+
+def gen_hull(n, rnd):
+    gnf = GNF()
+    npoints = n * 2
+    pvars = []
+    for i in range(npoints):
+        v = gnf.newVar()
+        pvars.append(v)
+        gnf.add("point 0 %d 2 %d %d" % (v, rnd.randint(0, 100), rnd.randint(0, 100)))
+    #choose at most 8 points, whose hull must cover a large area.
+    #(theory atoms can't be shared between theories, so the cardinality constraint is over copies of the point variables)
+    k = 8
+    svars = []
+    for v in pvars:
+        s = gnf.newVar()
+        svars.append(s)
+        gnf.addClause(-v, s)
+    gnf.add("pb %d %s 0 <= %d" % (npoints, " ".join(str(s) for s in svars), k))
+    a = gnf.newVar()
+    gnf.add("convex_hull_area_gt 0 %d %d" % (a, 9000))
+    gnf.addClause(a)
+    exclusions(gnf, pvars, npoints // 2, rnd)
+    return gnf
+
+
+#Each family maps to its generator and the default sizes used by the benchmark suite
+FAMILIES = {
+    "reach": (gen_reach, [10, 20, 30]),
+    "distance": (gen_distance, [16, 24, 32]),
+    "maxflow": (gen_maxflow, [14, 20, 28]),
+    "mst": (gen_mst, [20, 30, 60]),
+    "acyclic": (gen_acyclic, [40, 160, 320]),
+    "bv": (gen_bv, [16, 32, 64]),
+    "fsm": (gen_fsm, [10, 12, 14]),
+    "hull": (gen_hull, [40, 80, 160]),
+}
+
+
+def instance_name(family, size, seed):
+    return "%s_%d_%d.gnf" % (family, size, seed)
+
+
+def generate(family, size, seed, directory):
+    gen, _ = FAMILIES[family]
+    #seed from the instance name, so that every instance is independent of the others in the suite
+    rnd = random.Random("%s/%d/%d" % (family, size, seed))
+    gnf = gen(size, rnd)
+    path = os.path.join(directory, instance_name(family, size, seed))
+    with open(path, "w") as f:
+        f.write("c generated by benchmarks/generate.py: family %s, size %d, seed %d\n" % (family, size, seed))
+        gnf.write(f)
+    return path
+
+
+def generate_suite(directory, families=None, sizes=None, seeds=1):
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+    instances = []
+    for family in sorted(families or FAMILIES.keys()):
+        for size in (sizes or FAMILIES[family][1]):
+            for seed in range(seeds):
+                instances.append((family, size, seed, generate(family, size, seed, directory)))
+    return instances
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate reproducible GNF benchmark instances")
+    parser.add_argument("directory", help="directory to write the instances to")
+    parser.add_argument("--family", action="append", choices=sorted(FAMILIES.keys()),
+                        help="family to generate (may be repeated; default: all)")
+    parser.add_argument("--size", type=int, action="append", help="instance size (may be repeated; default: per family)")
+    parser.add_argument("--seeds", type=int, default=1, help="number of seeds per size")
+    args = parser.parse_args()
+    for (family, size, seed, path) in generate_suite(args.directory, args.family, args.size, args.seeds):
+        print(path)
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#The MIT License (MIT)
+#
+#Copyright (c) 2014, Sam Bayless
+#
+#Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+#associated documentation files (the "Software"), to deal in the Software without restriction,
+#including without limitation the rights to use, copy, modify, merge, publish, distribute,
+#sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+#furnished to do so, subject to the following conditions:
+#
+#The above copyright notice and this permission notice shall be included in all copies or
+#substantial portions of the Software.
+#
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+#NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+#NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+#DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+#OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#Runs the monosat binary over the generated benchmark families, and records one JSON object per
+#(instance, configuration) run: the result, solve time, propagations and conflicts per second,
+#per-theory and per-detector update times (from -stats-json), and the peak RSS of the process.
+#
+#Examples:
+#  run_benchmarks.py --binary Release/monosat --out base.jsonl
+#  run_benchmarks.py --binary Release/monosat --config "dinitz:-maxflow=dinitz" --config "ek:-maxflow=edmondskarp" --family maxflow
+#  run_benchmarks.py --compare base.jsonl new.jsonl
+
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import generate
+
+
+def detector_times(stats):
+    #sum the update times of each kind of detector, across all theories
+    times = {}
+    for theory in stats["solver"]["theories"]:
+        for d in theory.get("detectors", []):
+            t = times.setdefault(d["name"], 0.0)
+            times[d["name"]] = t + d["under_update"]["seconds"] + d["over_update"]["seconds"]
+    return times
+
+
+def run(binary, instance, config_args, timeout):
+    fd, stats_file = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    args = [binary] + config_args + ["-stats-json=" + stats_file, instance]
+    start = time.time()
+    proc = subprocess.Popen(args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    timed_out = False
+    #wait4 reports the resource usage of this one child, including its peak RSS
+    deadline = start + timeout
+    while True:
+        pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+        if pid != 0:
+            break
+        if time.time() > deadline:
+            proc.kill()
+            pid, status, usage = os.wait4(proc.pid, 0)
+            timed_out = True
+            break
+        time.sleep(0.005)
+    #the child has been reaped, so don't let Popen wait on it again
+    proc.returncode = status
+    wall = time.time() - start
+    #ru_maxrss is in kilobytes on linux, but bytes on osx
+    rss_mb = usage.ru_maxrss / (1024.0 * 1024.0 if sys.platform == "darwin" else 1024.0)
+    record = {"wall_time": wall, "peak_rss_mb": rss_mb, "timeout": timed_out}
+    stats = None
+    if not timed_out:
+        try:
+            with open(stats_file) as f:
+                stats = json.load(f)
+        except (IOError, ValueError):
+            stats = None
+    os.remove(stats_file)
+    if stats is None:
+        record["result"] = "timeout" if timed_out else "error"
+        return record
+    solver = stats["solver"]
+    solve_time = max(stats["solving_time"], 1e-9)
+    record.update({
+        "result": stats["result"],
+        "solve_time": stats["solving_time"],
+        "parse_time": stats["parsing_time"],
+        "cpu_time": stats["cpu_time"],
+        "conflicts": solver["conflicts"],
+        "decisions": solver["decisions"],
+        "propagations": solver["propagations"],
+        "propagations_per_sec": solver["propagations"] / solve_time,
+        "conflicts_per_sec": solver["conflicts"] / solve_time,
+        "theory_propagate_time": dict(("%d" % t["index"], t["propagate"]["seconds"]) for t in solver["theories"]),
+        "detector_update_time": detector_times(stats),
+    })
+    return record
+
+
+def parse_config(s):
+    #"name:args", or just "args" (which is then also used as the name)
+    if ":" in s and not s.startswith("-"):
+        name, args = s.split(":", 1)
+    else:
+        name, args = s, s
+    return name, shlex.split(args)
+
+
+def compare(base_file, new_file):
+    def load(fn):
+        runs = {}
+        with open(fn) as f:
+            for line in f:
+                if line.strip():
+                    r = json.loads(line)
+                    runs[(r["instance"], r["config"])] = r
+        return runs
+    base = load(base_file)
+    new = load(new_file)
+    print("%-28s %-12s %10s %10s %8s %12s %12s" % ("instance", "config", "base (s)", "new (s)", "speedup",
+                                                    "base prop/s", "new prop/s"))
+    total_base = 0
+    total_new = 0
+    for key in sorted(base.keys()):
+        if key not in new:
+            continue
+        b = base[key]
+        n = new[key]
+        if "solve_time" not in b or "solve_time" not in n:
+            print("%-28s %-12s %10s %10s" % (key[0], key[1], b["result"], n["result"]))
+            continue
+        if b["result"] != n["result"]:
+            print("WARNING: %s (%s) was %s, now %s" % (key[0], key[1], b["result"], n["result"]))
+        total_base += b["solve_time"]
+        total_new += n["solve_time"]
+        print("%-28s %-12s %10.3f %10.3f %8.2f %12.0f %12.0f" % (key[0], key[1], b["solve_time"], n["solve_time"],
+                                                              b["solve_time"] / max(n["solve_time"], 1e-9),
+                                                              b["propagations_per_sec"], n["propagations_per_sec"]))
+    print("total: %.3f s -> %.3f s" % (total_base, total_new))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark monosat over generated GNF instances")
+    parser.add_argument("--binary", default="./monosat", help="monosat executable to benchmark")
+    parser.add_argument("--dir", default=None, help="directory for the generated instances (default: a temporary directory)")
+    parser.add_argument("--family", action="append", choices=sorted(generate.FAMILIES.keys()),
+                        help="family to run (may be repeated; default: all)")
+    parser.add_argument("--size", type=int, action="append", help="instance size (may be repeated; default: per family)")
+    parser.add_argument("--seeds", type=int, default=1, help="number of seeds per size")
+    parser.add_argument("--config", action="append",
+                        help="solver options to benchmark, as 'name:options' (may be repeated; default: no options)")
+    parser.add_argument("--repeat", type=int, default=1, help="number of runs of each instance and configuration")
+    parser.add_argument("--timeout", type=float, default=300, help="timeout in seconds for each run")
+    parser.add_argument("--out", default=None, help="write results (one JSON object per line) to this file")
+    parser.add_argument("--compare", nargs=2, metavar=("BASE", "NEW"), help="compare two result files, and exit")
+    args = parser.parse_args()
+
+    if args.compare:
+        compare(args.compare[0], args.compare[1])
+        return
+
+    directory = args.dir or tempfile.mkdtemp(prefix="monosat_bench")
+    instances = generate.generate_suite(directory, args.family, args.size, args.seeds)
+    configs = [parse_config(c) for c in (args.config or ["default:"])]
+    out = open(args.out, "w") if args.out else sys.stdout
+    try:
+        for (family, size, seed, path) in instances:
+            for (name, config_args) in configs:
+                for r in range(args.repeat):
+                    record = {"instance": os.path.basename(path), "family": family, "size": size, "seed": seed,
+                              "config": name, "options": " ".join(config_args), "run": r}
+                    record.update(run(args.binary, path, config_args, args.timeout))
+                    out.write(json.dumps(record, sort_keys=True) + "\n")
+                    out.flush()
+                    if args.out:
+                        print("%-28s %-12s %-8s %8.3f s" % (record["instance"], name, record["result"],
+                                                           record.get("solve_time", record["wall_time"])))
+    finally:
+        if args.out:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
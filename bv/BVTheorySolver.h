@@ -3792,7 +3792,7 @@ public:
 	long stats_build_condition_arg_reason=0;
 	long stats_build_addition_reason=0;
 	long stats_build_addition_arg_reason =0;
-	double stats_update_time=0;
+	ProfileCounter update_profile;
 	double reachupdatetime = 0;
 	double unreachupdatetime = 0;
 	double stats_initial_propagation_time = 0;
@@ -3856,7 +3856,7 @@ public:
 
 
 		printf("Propagations: %ld (%f s, avg: %f s, %ld skipped), bv updates: %ld (%f s), bv propagations %ld (%ld skipped)\n", stats_propagations, propagationtime,
-				(propagationtime) / ((double) stats_propagations + 1), stats_propagations_skipped,statis_bv_updates,stats_update_time,stats_bv_propagations,stats_bv_skipped_propagations);
+				(propagationtime) / ((double) stats_propagations + 1), stats_propagations_skipped,statis_bv_updates,update_profile.seconds(),stats_bv_propagations,stats_bv_skipped_propagations);
 		printf("Decisions: %ld (%f s, avg: %f s)\n", stats_decisions, stats_decision_time,
 				(stats_decision_time) / ((double) stats_decisions + 1));
 		printf("Conflicts: %ld (bits: %ld, additions: %ld, comparisons: %ld, bv comparisons: %ld), %f seconds\n", stats_num_conflicts,stats_bit_conflicts,stats_addition_conflicts,stats_compare_conflicts,stats_bv_compare_conflicts, stats_conflict_time);
@@ -3866,6 +3866,20 @@ public:
 
 		fflush(stdout);
 	}
+
+	void writeStatsJSON(std::ostream & out) {
+		out << "{\"index\":" << this->getTheoryIndex() << ",\"type\":\"bv\"";
+		out << ",\"bitvectors\":" << bitvectors.size();
+		out << ",\"propagate\":";
+		getPropagationProfile().writeJSON(out);
+		out << ",\"update\":";
+		update_profile.writeJSON(out);
+		out << ",\"bv_propagations\":" << stats_bv_propagations << ",\"skipped_bv_propagations\":"
+				<< stats_bv_skipped_propagations;
+		out << ",\"decisions\":" << stats_decisions << ",\"conflicts\":" << stats_num_conflicts << ",\"reasons\":"
+				<< stats_num_reasons;
+		out << "}";
+	}
 	
 	void writeTheoryWitness(std::ostream& write_to) {
 		for(int bvID = 0;bvID<bitvectors.size();bvID++){
@@ -4833,7 +4847,7 @@ public:
 		if(bvID==1288){
 			int a=1;
 		}
-		double update_start_time= rtime(3);
+		ScopedProfile update_profile_scope(update_profile);
 		statis_bv_updates++;
 		static int iter = 0;
 		++iter;
@@ -5038,7 +5052,6 @@ public:
 			std::cout<< "q bv " << getSymbol(bvID) << " " << under_approx[bvID] << " <= bv <=" <<  over_approx[bvID] << "\n" ;
 		}*/
 		writeBounds(bvID);
-		stats_update_time+= rtime(3) -update_start_time;
 		return 	any_changed;//return whether either weight has changed.
 	}
 
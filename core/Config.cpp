@@ -51,6 +51,13 @@ DoubleOption Monosat::opt_random_seed(_cat, "rnd-seed", "Used by the random vari
 		DoubleRange(0, false, HUGE_VAL, false));
 IntOption Monosat::opt_ccmin_mode(_cat, "ccmin-mode", "Controls conflict clause minimization (0=none, 1=basic, 2=deep)",
 		2, IntRange(0, 2));
+BoolOption Monosat::opt_shrink(_cat, "shrink",
+		"Shrink learnt clauses by replacing the literals of each decision level with their first UIP on that level, where possible",
+		false);
+BoolOption Monosat::opt_binary_minimize(_cat, "bin-minimize",
+		"Minimize learnt clauses by resolution with the binary clauses of their asserting literal", true);
+BoolOption Monosat::opt_theory_minimize(_cat, "theory-minimize",
+		"Minimize conflict clauses from theory solvers (as learnt clauses are minimized) before learning them", false);
 IntOption Monosat::opt_phase_saving(_cat, "phase-saving",
 		"Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 BoolOption Monosat::opt_rnd_init_act(_cat, "rnd-init", "Randomize the initial activity", false);
@@ -61,6 +68,10 @@ DoubleOption Monosat::opt_restart_inc(_cat, "rinc", "Restart interval increase f
 DoubleOption Monosat::opt_garbage_frac(_cat, "gc-frac",
 		"The fraction of wasted memory allowed before a garbage collection is triggered", 0.20,
 		DoubleRange(0, false, HUGE_VAL, false));
+IntOption Monosat::opt_watch_pos_size(_cat, "watch-pos-size",
+		"Clauses with at least this many literals resume the search for a new watch where the previous search left off (0 to disable)",
+		0, IntRange(0, INT32_MAX));
+BoolOption Monosat::opt_watch_prefetch(_cat, "watch-prefetch", "Prefetch the clause of the next watcher during unit propagation", true);
 BoolOption Monosat::opt_pre("MAIN", "pre", "Completely turn on/off any preprocessing.", true);
 IntOption Monosat::opt_time(_cat, "verb-time", "Detail level of timing benchmarks (these add some overhead)", 0,
 		IntRange(0, 5));
@@ -103,6 +114,84 @@ BoolOption Monosat::opt_early_theory_prop(_cat, "early-theory-prop",
 		"If false, the solver waits until all literals are propagated before propagating theories; if true, theories are propagated while the solver is still propagating literals",
 		false);
 
+BoolOption Monosat::opt_theory_schedule(_cat, "theory-schedule",
+		"Measure the cost and yield of each theory's propagation, and propagate cheap theories (and unit propagation) to a fixpoint before expensive ones; if false, theories are propagated in LIFO order",
+		true);
+
+DoubleOption Monosat::opt_theory_schedule_cheap(_cat, "theory-schedule-cheap",
+		"Theories whose average propagation time (in ms) is at most this much are considered cheap, and may be propagated while the solver is still propagating literals (if early-theory-prop is set)",
+		0.01, DoubleRange(0, true, HUGE_VAL, true));
+
+IntOption Monosat::opt_chrono(_cat, "chrono",
+		"Backtrack chronologically (undoing only the conflict level) instead of backjumping, if the backjump would undo more than this many decision levels (-1 to always backjump). Keeping the intermediate levels avoids backtracking and re-propagating the theory solvers.",
+		100, IntRange(-1, INT32_MAX));
+
+IntOption Monosat::opt_chrono_conflicts(_cat, "chrono-conflicts",
+		"Number of conflicts before chronological backtracking is enabled", 4000, IntRange(0, INT32_MAX));
+
+BoolOption Monosat::opt_inprocess(_cat, "inprocess",
+		"Periodically simplify the clause database at restarts (learnt clause vivification, subsumption, and elimination of pure Boolean variables)",
+		true);
+
+IntOption Monosat::opt_inprocess_interval(_cat, "inprocess-interval",
+		"Number of conflicts between inprocessing rounds", 10000, IntRange(1, INT32_MAX));
+
+IntOption Monosat::opt_inprocess_effort(_cat, "inprocess-effort",
+		"Maximum number of propagations (for vivification) and literal visits (for subsumption and elimination) in each inprocessing round",
+		1000000, IntRange(0, INT32_MAX));
+
+BoolOption Monosat::opt_inprocess_elim(_cat, "inprocess-elim",
+		"Eliminate pure Boolean (non-theory, non-frozen) variables during inprocessing (only if SAT preprocessing is enabled)",
+		true);
+
+BoolOption Monosat::opt_lbd_restart(_cat, "lbd-restart",
+		"Restart dynamically (as in Glucose), when the average LBD of the most recent learnt clauses is high compared to the average over all conflicts, instead of following the luby/geometric restart sequence",
+		false);
+
+IntOption Monosat::opt_lbd_restart_window(_cat, "lbd-restart-window",
+		"Number of recent learnt clauses whose average LBD is compared against the overall average (if lbd-restart is set)", 50,
+		IntRange(1, INT32_MAX));
+
+DoubleOption Monosat::opt_lbd_restart_k(_cat, "lbd-restart-k",
+		"Restart if the recent average LBD, times this factor, exceeds the overall average LBD (if lbd-restart is set)", 0.8,
+		DoubleRange(0, false, 1, true));
+
+BoolOption Monosat::opt_restart_blocking(_cat, "restart-block",
+		"Postpone dynamic restarts while the trail is much larger than usual, as the solver may be close to a satisfying assignment (if lbd-restart is set)",
+		true);
+
+IntOption Monosat::opt_restart_block_window(_cat, "restart-block-window",
+		"Number of recent conflicts over which the average trail size is measured, for restart blocking", 5000,
+		IntRange(1, INT32_MAX));
+
+DoubleOption Monosat::opt_restart_block_r(_cat, "restart-block-r",
+		"Block restarts if the trail is larger than this factor times the recent average trail size", 1.4,
+		DoubleRange(1, true, HUGE_VAL, false));
+
+IntOption Monosat::opt_restart_block_conflicts(_cat, "restart-block-conflicts",
+		"Number of conflicts before restart blocking is enabled", 10000, IntRange(0, INT32_MAX));
+
+BoolOption Monosat::opt_target_phase(_cat, "target-phase",
+		"Decide variables using the phases of the largest trail reached since the last rephase (falling back on the saved phase)",
+		false);
+
+StringOption Monosat::opt_decision_heuristic(_cat, "decision-heuristic",
+		"Variable decision heuristic: 'vsids' (activity heap), 'vmtf' (variable move-to-front queue, with constant time bumps and decisions), or 'chb' (conflict history based scores)",
+		"vsids");
+
+DoubleOption Monosat::opt_chb_step(_cat, "chb-step", "Initial step size of the CHB score updates (if decision-heuristic=chb)", 0.4,
+		DoubleRange(0, false, 1, true));
+
+DoubleOption Monosat::opt_chb_min_step(_cat, "chb-min-step", "Minimum step size of the CHB score updates", 0.06,
+		DoubleRange(0, false, 1, true));
+
+DoubleOption Monosat::opt_chb_step_decay(_cat, "chb-step-decay", "Amount the CHB step size is decreased by after each conflict",
+		0.000001, DoubleRange(0, true, 1, true));
+
+IntOption Monosat::opt_rephase_interval(_cat, "rephase",
+		"Reset the saved phases at restarts, cycling through the best, original, inverted and random phases, after this many conflicts (growing arithmetically; 0 to disable)",
+		0, IntRange(0, INT32_MAX));
+
  BoolOption Monosat::opt_remap_vars(_cat,"remap-vars","Remap variables in the GNF internally in the solver, to minimize space required",true);
  BoolOption Monosat::opt_decide_optimization_lits(_cat_opt,"decide-opt-lits","Allow decisions on literals introduced by optimization constraints",true);
  BoolOption  Monosat::opt_binary_search_optimization(_cat_opt,"binary-search","Use binary search (instead of linear search) for optimization constraints",true);
@@ -128,6 +217,9 @@ IntOption Monosat::opt_temporary_theory_conflicts(_cat_sms, "temporary-theory-co
 IntOption Monosat::opt_temporary_theory_reasons(_cat_sms, "temporary-theory-reasons",
 		"True if theory reason clauses larger than this size should be discarded immediately.", INT32_MAX,
 		IntRange(0, INT32_MAX));
+BoolOption Monosat::opt_theory_reason_cache(_cat_sms, "theory-reason-cache",
+		"Reuse the last reason clause built by a theory for a literal, if it still explains that literal, instead of asking the theory to rebuild it",
+		true);
 BoolOption Monosat::opt_graph(_cat_graph, "graph", "Use graph theory solver", true);
 BoolOption Monosat::opt_inc_graph(_cat_graph, "inc", "Use incremental graph reachability", false);
 IntOption Monosat::opt_dec_graph(_cat_graph, "dec", "Use decremental graph reachability", 0, IntRange(0, 2));
@@ -163,13 +255,16 @@ BoolOption Monosat::opt_conflict_min_cut_maxflow(_cat_graph, "conflict-min-cut-m
 		"Use min-cut (instead of arbitrary cut) for conflict resolution for maximum flow properties", false);
 
 IntOption Monosat::opt_history_clear(_cat_graph, "history-clear",
-		"Rate at which the history of dynamic graphs is cleared", 1000, IntRange(1, INT32_MAX));
+		"Maximum length of the history of dynamic graphs; changes are discarded once every algorithm has read them, or once the history exceeds this length", 1000, IntRange(1, INT32_MAX));
 IntOption Monosat::opt_adaptive_history_clear(_cat_graph, "adaptive-history-clear",
 		"If >0, ignore the history clear option, and instead set the history clear rate to be this value multiplied by the number of edges in the graph",
 		0, IntRange(0, INT32_MAX));
 BoolOption Monosat::disable_history_clears(_cat_graph,"disable-history-clear","",false);
-IntOption Monosat::opt_dynamic_history_clear(_cat_graph, "dynamic-history-clear", "0=dont use dynamic history clears,1=use opportunistic dynamic history clears (falling back on normal history clears if that fails), 2=force dynamic history clears",0, IntRange(0, 2));
+IntOption Monosat::opt_dynamic_history_clear(_cat_graph, "dynamic-history-clear", "2=bring lagging dynamic algorithms up to date before discarding history that they have not yet read (0,1=let them recompute from scratch instead)",0, IntRange(0, 2));
 
+BoolOption Monosat::opt_batch_edges(_cat_graph, "batch-edges",
+		"Apply edge assignments to the graphs in a single batch when the graph theory next propagates, rather than one at a time as they are enqueued (assignments that are backtracked before then are never applied)",
+		true);
 BoolOption Monosat::opt_lazy_backtrack(_cat_graph, "lazy-backtrack", "", false);
 BoolOption Monosat::opt_lazy_backtrack_decisions(_cat_graph, "lazy-backtrack-decisions", "", false);
 IntOption Monosat::opt_lazy_conflicts(_cat_graph, "lazy-conflicts", "0= unassign all lazy lits and reprop, 1=unassign all lazy lits in the clause, reprop, 2=unassign one lit, reprop, 3=skip lazy conflict analysis",0,IntRange(0,3));
@@ -263,6 +358,9 @@ BoolOption Monosat::opt_detect_pure_theory_lits(_cat, "detect-pure-theory-lits",
 
 BoolOption Monosat::opt_mst_min_cut(_cat_graph, "mst-min-cut",
 		"Search for a min-cut during conflict resolution of disconnected minimum spanning trees", true);
+IntOption Monosat::opt_steiner_exact_terminals(_cat_graph, "steiner-exact-terminals",
+		"Compute exact minimum steiner trees (by dynamic programming over subsets of terminals) when at most this many terminals are enabled, instead of approximating them (0 to always approximate)",
+		8, IntRange(0, 16));
 BoolOption Monosat::opt_connected_components_min_cut(_cat_graph, "cc-mincut",
 		"Search for a min-cut during conflict resolution of connected components", true);
 BoolOption Monosat::opt_optimize_mst(_cat_graph, "opt-mst",
@@ -302,6 +400,9 @@ IntOption Monosat::opt_adaptive_conflict_mincut(_cat_graph, "adaptive-conflict-m
 
 BoolOption Monosat::opt_shortest_path_prune_dist(_cat_graph, "shortest-paths-prune-dist",
 		"Prune edges based on distances from learnt clauses for the shortest paths theory", false);
+IntOption Monosat::opt_dist_alt_targets(_cat_graph, "dist-alt-targets",
+		"Use goal-directed search (guided by distance lower bounds computed at level 0) instead of Dijkstra for weighted shortest path constraints from sources with at most this many distinct targets (0 to disable)",
+		4, IntRange(0, INT32_MAX));
 
 ConvexHullAlg Monosat::hullAlg = ConvexHullAlg::ALG_MONOTONE_HULL;
 
@@ -357,5 +458,6 @@ AllPairsConnectivityAlg Monosat::undirected_allpairsalg = AllPairsConnectivityAl
 ComponentsAlg Monosat::componentsalg = ComponentsAlg::ALG_DISJOINT_SETS;
 MinSpanAlg Monosat::mstalg = MinSpanAlg::ALG_KRUSKAL;
 CycleAlg Monosat::cyclealg= CycleAlg::ALG_PK_CYCLE;
+DecisionHeuristic Monosat::decisionheuristic = DecisionHeuristic::VSIDS;
 
 PointInPolygonAlg Monosat::pipalg = PointInPolygonAlg::ALG_RECURSIVE_SPLIT;
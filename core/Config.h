@@ -33,11 +33,16 @@ extern DoubleOption opt_random_var_freq;
 extern DoubleOption opt_random_seed;
 extern IntOption opt_ccmin_mode;
 extern IntOption opt_phase_saving;
+extern BoolOption opt_shrink;
+extern BoolOption opt_binary_minimize;
+extern BoolOption opt_theory_minimize;
 extern BoolOption opt_rnd_init_act;
 extern BoolOption opt_luby_restart;
 extern IntOption opt_restart_first;
 extern DoubleOption opt_restart_inc;
 extern DoubleOption opt_garbage_frac;
+extern IntOption opt_watch_pos_size;
+extern BoolOption opt_watch_prefetch;
 extern BoolOption opt_rnd_restart;
 extern BoolOption opt_rnd_theory_restart;
 extern StringOption opt_record_file;
@@ -84,6 +89,7 @@ extern StringOption opt_cycle_alg;
 extern IntOption opt_adaptive_history_clear;
 extern BoolOption disable_history_clears;
 extern IntOption opt_dynamic_history_clear;
+extern BoolOption opt_batch_edges;
 extern BoolOption opt_lazy_backtrack;
 extern BoolOption opt_lazy_backtrack_decisions;
 extern IntOption opt_lazy_conflicts;
@@ -128,6 +134,7 @@ extern BoolOption opt_decide_graph_pos;
 extern BoolOption opt_ignore_theories;
 extern BoolOption opt_check_pure_theory_lits;
 extern BoolOption opt_mst_min_cut;
+extern IntOption opt_steiner_exact_terminals;
 extern BoolOption opt_connected_components_min_cut;
 extern BoolOption opt_optimize_mst;
 extern BoolOption opt_skip_deletions;
@@ -135,6 +142,7 @@ extern BoolOption opt_skip_additions;
 extern BoolOption opt_permanent_theory_conflicts;
 extern IntOption opt_temporary_theory_conflicts;
 extern IntOption opt_temporary_theory_reasons;
+extern BoolOption opt_theory_reason_cache;
 extern BoolOption opt_force_directed;
 extern BoolOption opt_decide_graph_chokepoints;
 extern IntOption opt_sort_graph_decisions;
@@ -145,6 +153,27 @@ extern BoolOption opt_detect_pure_lits;
 extern BoolOption opt_propagate_theories_during_simplification;
 extern BoolOption opt_shrink_theory_conflicts;
 extern BoolOption opt_early_theory_prop;
+extern BoolOption opt_theory_schedule;
+extern DoubleOption opt_theory_schedule_cheap;
+extern IntOption opt_chrono;
+extern IntOption opt_chrono_conflicts;
+extern BoolOption opt_inprocess;
+extern IntOption opt_inprocess_interval;
+extern IntOption opt_inprocess_effort;
+extern BoolOption opt_inprocess_elim;
+extern BoolOption opt_lbd_restart;
+extern IntOption opt_lbd_restart_window;
+extern DoubleOption opt_lbd_restart_k;
+extern BoolOption opt_restart_blocking;
+extern IntOption opt_restart_block_window;
+extern DoubleOption opt_restart_block_r;
+extern IntOption opt_restart_block_conflicts;
+extern BoolOption opt_target_phase;
+extern IntOption opt_rephase_interval;
+extern StringOption opt_decision_heuristic;
+extern DoubleOption opt_chb_step;
+extern DoubleOption opt_chb_min_step;
+extern DoubleOption opt_chb_step_decay;
 extern IntOption opt_width;
 extern IntOption opt_height;
 extern IntOption opt_bits;
@@ -177,6 +206,7 @@ extern IntOption opt_maxflow_decision_paths;
 extern BoolOption opt_reach_detector_combined_maxflow;
 extern IntOption opt_adaptive_conflict_mincut;
 extern BoolOption opt_shortest_path_prune_dist;
+extern IntOption opt_dist_alt_targets;
 extern BoolOption opt_graph_bv_prop;
 
 extern IntOption opt_graph_prop_skip;
@@ -255,6 +285,11 @@ enum class DistAlg {
 
 extern DistAlg distalg;
 
+enum class DecisionHeuristic {
+	VSIDS, VMTF, CHB
+};
+extern DecisionHeuristic decisionheuristic;
+
 extern IntOption opt_time;
 
 static inline double rtime(int level = 1) {
@@ -45,7 +45,7 @@ Solver::Solver() :
 		verbosity(opt_verb), var_decay(opt_var_decay), clause_decay(opt_clause_decay), theory_decay(opt_var_decay), random_var_freq(
 				opt_random_var_freq), random_seed(opt_random_seed), luby_restart(opt_luby_restart), ccmin_mode(
 				opt_ccmin_mode), phase_saving(opt_phase_saving), rnd_pol(false), rnd_init_act(opt_rnd_init_act), garbage_frac(
-				opt_garbage_frac), restart_first(opt_restart_first), restart_inc(opt_restart_inc)
+				opt_garbage_frac), prefetch_watches(opt_watch_prefetch), restart_first(opt_restart_first), restart_inc(opt_restart_inc)
 
 		// Parameters (the rest):
 		//
@@ -60,12 +60,18 @@ Solver::Solver() :
 				, solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), stats_pure_lits(
 				0), stats_pure_theory_lits(0), pure_literal_detections(0), stats_removed_clauses(0), dec_vars(0), clauses_literals(
 				0), learnts_literals(0), max_literals(0), tot_literals(0), stats_pure_lit_time(0),  ok(
-				true), cla_inc(1), var_inc(1), theory_inc(1), watches(WatcherDeleted(ca)), qhead(0), simpDB_assigns(-1), simpDB_props(
+				true), cla_inc(1), var_inc(1), theory_inc(1), watches(WatcherDeleted(ca)), binary_watches(WatcherDeleted(ca)), qhead(0), simpDB_assigns(-1), simpDB_props(
 				0), order_heap(VarOrderLt(activity, priority)),theory_order_heap(TheoryOrderLt(theories)), progress_estimate(0), remove_satisfied(true) //lazy_heap( LazyLevelLt(this)),
 
 		// Resource constraints:
 		//
 				, conflict_budget(-1), propagation_budget(-1) {
+			lbd_queue.init(opt_lbd_restart_window);
+			trail_queue.init(opt_restart_block_window);
+			next_rephase = opt_rephase_interval;
+			decision_heuristic = decisionheuristic;
+			chb_step = opt_chb_step;
+			ca.saved_pos_min_size = opt_watch_pos_size;
 			if(opt_vsids_solver_as_theory){
 				decisionTheory = new SolverDecisionTheory(*this);
 				this->addTheory(decisionTheory);
@@ -89,18 +95,26 @@ Var Solver::newVar(bool sign, bool dvar) {
 	int v = nVars();
 	watches.init(mkLit(v, false));
 	watches.init(mkLit(v, true));
+	binary_watches.init(mkLit(v, false));
+	binary_watches.init(mkLit(v, true));
 	assigns.push(l_Undef);
-	vardata.push(mkVarData(CRef_Undef, 0));
+	vardata.push({CRef_Undef, 0, 0, 0});
+	reason_cache.push(CRef_Undef);
 	int p = 0;
 	if (max_decision_var > 0 && v > max_decision_var)
 		p = 1;
 	if (v < min_decision_var)
 		p = 1;
 	priority.push(p);
-	theory_vars.push();
+	theory_vars.push(var_Undef);
 	activity.push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
 	seen.push(0);
+	chb_last_conflict.push(0);
+	shrink_stamp.push(0);
 	polarity.push(opt_init_rnd_phase ? irand(random_seed, 1) : sign);
+	original_polarity.push(polarity.last());
+	target_phase.push(l_Undef);
+	best_phase.push(l_Undef);
 	decision.push();
 	trail.capacity(v + 1);
 	if (max_decision_var > 0 && v > max_decision_var)
@@ -318,8 +332,9 @@ void Solver::attachClause(CRef cr) {
 			}
 		}
 #endif
-	watches[~c[0]].push(Watcher(cr, c[1]));
-	watches[~c[1]].push(Watcher(cr, c[0]));
+	OccLists<Lit, vec<Watcher>, WatcherDeleted> & ws = c.size() == 2 ? binary_watches : watches;
+	ws[~c[0]].push(Watcher(cr, c[1]));
+	ws[~c[1]].push(Watcher(cr, c[0]));
 	if (c.learnt())
 		learnts_literals += c.size();
 	else
@@ -330,13 +345,14 @@ void Solver::detachClause(CRef cr, bool strict) {
 	const Clause& c = ca[cr];
 	assert(c.size() > 1);
 	
+	OccLists<Lit, vec<Watcher>, WatcherDeleted> & ws = c.size() == 2 ? binary_watches : watches;
 	if (strict) {
-		remove(watches[~c[0]], Watcher(cr, c[1]));
-		remove(watches[~c[1]], Watcher(cr, c[0]));
+		remove(ws[~c[0]], Watcher(cr, c[1]));
+		remove(ws[~c[1]], Watcher(cr, c[0]));
 	} else {
 		// Lazy detaching: (NOTE! Must clean all watcher lists before garbage collecting this clause)
-		watches.smudge(~c[0]);
-		watches.smudge(~c[1]);
+		ws.smudge(~c[0]);
+		ws.smudge(~c[1]);
 	}
 	
 	if (c.learnt())
@@ -349,8 +365,9 @@ void Solver::removeClause(CRef cr) {
 	Clause& c = ca[cr];
 	detachClause(cr);
 	// Don't leave pointers to free'd memory!
-	if (locked(c))
-		vardata[var(c[0])].reason = CRef_Undef;
+	Lit implied = lockedLit(c);
+	if (implied != lit_Undef)
+		vardata[var(implied)].reason = CRef_Undef;
 	c.mark(1);
 	ca.free(cr);
 }
@@ -366,6 +383,14 @@ bool Solver::satisfied(const Clause& c) const {
 //
 void Solver::cancelUntil(int lev) {
 	if (decisionLevel() > lev) {
+		if ((opt_target_phase || opt_rephase_interval > 0) && trail.size() > target_assigned)
+			updatePhases();
+		double chb_multiplier = 1;
+		if (decision_heuristic == DecisionHeuristic::CHB) {
+			//variables unassigned without an intervening conflict (eg, at a restart) receive a smaller reward
+			chb_multiplier = conflicts > chb_backtrack_conflicts ? 1 : 0.9;
+			chb_backtrack_conflicts = conflicts;
+		}
 
 		for (int i = 0; i < theories.size(); i++) {
 			if(opt_lazy_backtrack  && theories[i]->supportsLazyBacktracking()){
@@ -390,6 +415,8 @@ void Solver::cancelUntil(int lev) {
 				assigns[x] = l_Undef;
 				if (phase_saving > 1 || ((phase_saving == 1) && c > trail_lim.last()))
 					polarity[x] = sign(trail[c]);
+				if (decision_heuristic == DecisionHeuristic::CHB)
+					chbUnassign(x, chb_multiplier);
 				insertVarOrder(x);
 			}
 		}
@@ -424,6 +451,7 @@ void Solver::cancelUntil(int lev) {
 			Lit p = to_reenqueue.last();
 			to_reenqueue.pop();
 			assert(level(var(p)) <=lev);
+			vardata[var(p)].trail_index = trail.size();
 			trail.push(p);
 			//is this really needed?
 			if (hasTheory(p)) {
@@ -455,8 +483,20 @@ void Solver::backtrackUntil(int lev) {
 Lit Solver::pickBranchLit() {
 	Var next = var_Undef;
 	decisions++;
+	if (decision_heuristic == DecisionHeuristic::VMTF) {
+		// Random decision:
+		if (drand(random_seed) < random_var_freq && nVars() > 0) {
+			next = irand(random_seed, nVars());
+			if (value(next) == l_Undef && decision[next])
+				rnd_decisions++;
+			else
+				next = var_Undef;
+		}
+		if (next == var_Undef)
+			next = peekBranchVar();
+	}
 	// Random decision:
-	if (drand(random_seed) < random_var_freq && !order_heap.empty()) {
+	else if (drand(random_seed) < random_var_freq && !order_heap.empty()) {
 		next = order_heap[irand(random_seed, order_heap.size())];
 		if (value(next) == l_Undef && decision[next])
 			rnd_decisions++;
@@ -470,13 +510,114 @@ Lit Solver::pickBranchLit() {
 		} else
 			next = order_heap.removeMin();
 
-	return next == var_Undef ? lit_Undef : mkLit(next, rnd_pol ? drand(random_seed) < 0.5 : polarity[next]);
+	if (next == var_Undef)
+		return lit_Undef;
+	else if (rnd_pol)
+		return mkLit(next, drand(random_seed) < 0.5);
+	else if (opt_target_phase && target_phase[next] != l_Undef)
+		return mkLit(next, target_phase[next] == l_False);
+	else
+		return mkLit(next, polarity[next]);
+}
+
+Var Solver::peekBranchVar() {
+	if (decision_heuristic == DecisionHeuristic::VMTF) {
+		return vmtf_queue.next([&](Var v) {return value(v) != l_Undef || !decision[v];});
+	}
+	//remove decided vars from order heap
+	while (!order_heap.empty() && value(order_heap.peekMin()) != l_Undef) {
+		order_heap.removeMin();
+	}
+	return order_heap.empty() ? var_Undef : order_heap.peekMin();
+}
+
+// Move the variables bumped in the last conflict analysis to the front of the VMTF queue, in the order they were
+// previously in (so that their relative order is preserved).
+void Solver::vmtfBumpVars() {
+	struct StampLt {
+		const MoveToFrontQueue & queue;
+		bool operator ()(Var x, Var y) const {
+			return queue.stamp(x) < queue.stamp(y);
+		}
+		StampLt(const MoveToFrontQueue & queue) :
+				queue(queue) {
+		}
+	};
+	sort(vmtf_bumped, StampLt(vmtf_queue));
+	for (Var v : vmtf_bumped) {
+		if (vmtf_queue.inQueue(v)) {
+			vmtf_queue.moveToFront(v);
+			if (value(v) == l_Undef)
+				vmtf_queue.touch(v);
+		}
+	}
+	vmtf_bumped.clear();
+}
+
+// Returns the number of distinct decision levels (the 'literal block distance', as in Glucose) of the literals in 'lits'.
+unsigned int Solver::computeLBD(const vec<Lit>& lits) {
+	lbd_stamp_counter++;
+	unsigned int lbd = 0;
+	for (Lit l : lits) {
+		int lev = level(var(l));
+		if (lev >= lbd_stamp.size())
+			lbd_stamp.growTo(lev + 1, 0);
+		if (lbd_stamp[lev] != lbd_stamp_counter) {
+			lbd_stamp[lev] = lbd_stamp_counter;
+			lbd++;
+		}
+	}
+	return lbd;
+}
+
+// Called before backtracking: if the trail is larger than any since the last rephase, record its assignment as the
+// target phase (and, if it is also the largest since the best phases were last restored, as the best phase).
+void Solver::updatePhases() {
+	target_assigned = trail.size();
+	for (Lit l : trail)
+		target_phase[var(l)] = sign(l) ? l_False : l_True;
+	if (target_assigned > best_assigned) {
+		best_assigned = target_assigned;
+		for (Lit l : trail)
+			best_phase[var(l)] = sign(l) ? l_False : l_True;
+	}
+}
+
+// Reset the saved phases, cycling through the best, original, best, inverted, best and random phases (as in CaDiCaL,
+// but without a local search phase). The target phases are forgotten, so that they are re-learnt from the new phases.
+void Solver::rephase() {
+	stats_rephases++;
+	switch (rephases++ % 6) {
+	case 1:
+		for (Var v = 0; v < nVars(); v++)
+			polarity[v] = original_polarity[v];
+		break;
+	case 3:
+		for (Var v = 0; v < nVars(); v++)
+			polarity[v] = !original_polarity[v];
+		break;
+	case 5:
+		for (Var v = 0; v < nVars(); v++)
+			polarity[v] = irand(random_seed, 2);
+		break;
+	default:
+		for (Var v = 0; v < nVars(); v++)
+			if (best_phase[v] != l_Undef)
+				polarity[v] = best_phase[v] == l_False;
+		best_assigned = 0;
+		break;
+	}
+	for (Var v = 0; v < nVars(); v++)
+		target_phase[v] = l_Undef;
+	target_assigned = 0;
+	next_rephase = conflicts + opt_rephase_interval * (rephases + 1);
 }
 
 void Solver::instantiateLazyDecision(Lit p,int atLevel, CRef reason){
 	assert(value(p) == l_Undef);
 	assigns[var(p)] = lbool(!sign(p));
-	vardata[var(p)] = mkVarData(reason, atLevel);
+	vardata[var(p)].reason = reason;
+	vardata[var(p)].level = atLevel;
 	assert(atLevel<=decisionLevel());
 	assert(atLevel>0);
 	int trail_pos = trail_lim[atLevel-1];
@@ -488,6 +629,7 @@ void Solver::instantiateLazyDecision(Lit p,int atLevel, CRef reason){
 		exit(6);
 	}
 	trail[trail_pos]=p;
+	vardata[var(p)].trail_index = trail_pos;
 
 	if (hasTheory(p)) {
 		int theoryID = getTheoryID(p);
@@ -554,6 +696,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
 		if (confl != CRef_Undef) {
 			assert(!isTheoryCause(confl));
 			Clause& c = ca[confl];
+			if (p != lit_Undef)
+				reasonFirst(c, var(p));
 			
 			if (c.learnt())
 				claBumpActivity(c);
@@ -656,6 +800,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
 				out_learnt[j++] = out_learnt[i];
 			else {
 				Clause& c = ca[reason(var(out_learnt[i]))];
+				reasonFirst(c, x);
 				for (int k = 1; k < c.size(); k++)
 					if (!seen[var(c[k])] && level(var(c[k])) > 0) {
 						out_learnt[j++] = out_learnt[i];
@@ -668,6 +813,10 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
 	
 	max_literals += out_learnt.size();
 	out_learnt.shrink(i - j);
+	if (opt_shrink)
+		shrinkLearnt(out_learnt);
+	if (opt_binary_minimize)
+		binaryMinimize(out_learnt);
 	tot_literals += out_learnt.size();
 
 	// Find correct backtrack level:
@@ -718,6 +867,7 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
 		}
 		
 		Clause& c = ca[reason(var(analyze_stack.last()))];
+		reasonFirst(c, var(analyze_stack.last()));
 		analyze_stack.pop();
 		
 		for (int i = 1; i < c.size(); i++) {
@@ -740,6 +890,131 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
 	return true;
 }
 
+// Remove literals from the learnt clause by resolution with the binary clauses of its asserting literal:
+// if the binary clause (out_learnt[0] \/ l) exists, then ~l can be removed from the clause (as in Glucose).
+// Literals to remove are marked by setting 'seen' to 2; 'seen' must be set for every literal of the learnt clause.
+void Solver::binaryMinimize(vec<Lit>& out_learnt) {
+	if (out_learnt.size() <= 2)
+		return;
+	bool found = false;
+	vec<Watcher>& bws = binary_watches[~out_learnt[0]];
+	for (int k = 0; k < bws.size(); k++) {
+		Lit imp = bws[k].blocker;
+		if (seen[var(imp)] == 1 && value(imp) == l_True && ca[bws[k].cref].mark() == 0) {
+			seen[var(imp)] = 2;
+			found = true;
+		}
+	}
+	if (!found)
+		return;
+	int i, j;
+	for (i = j = 1; i < out_learnt.size(); i++) {
+		if (seen[var(out_learnt[i])] == 2)
+			stats_bin_minimized_lits++;
+		else
+			out_learnt[j++] = out_learnt[i];
+	}
+	out_learnt.shrink(i - j);
+}
+
+// All-UIP shrinking (Fleury and Biere, "Efficient All-UIP Learned Clause Minimization"): replace the literals of each
+// decision level of the learnt clause by the first UIP of those literals on that level, if the UIP's implication of
+// them only depends on literals (from earlier levels) that are already in, or implied by, the learnt clause.
+void Solver::shrinkLearnt(vec<Lit>& out_learnt) {
+	if (out_learnt.size() <= 3)
+		return;
+	struct LevelGt {
+		Solver & S;
+		bool operator ()(Lit a, Lit b) const {
+			return S.level(var(a)) > S.level(var(b));
+		}
+	};
+	sort(((Lit*) out_learnt) + 1, out_learnt.size() - 1, LevelGt { *this });
+	int i, j, start;
+	for (i = j = 1; i < out_learnt.size(); i = start) {
+		int lev = level(var(out_learnt[i]));
+		for (start = i; start < out_learnt.size() && level(var(out_learnt[start])) == lev; start++)
+			;
+		Lit uip = (start - i > 1 && lev < decisionLevel()) ? shrinkLevel(lev, out_learnt, i, start) : lit_Undef;
+		if (uip == lit_Undef) {
+			while (i < start)
+				out_learnt[j++] = out_learnt[i++];
+		} else {
+			stats_shrunk_lits += start - i - 1;
+			out_learnt[j++] = ~uip;
+			if (!seen[var(uip)]) {
+				seen[var(uip)] = 1;
+				analyze_toclear.push(~uip);
+			}
+		}
+	}
+	out_learnt.shrink(i - j);
+}
+
+// Find the first UIP of the literals out_learnt[from..to), which must all be at level 'lev', or return lit_Undef if it
+// cannot be used to replace them (see 'shrinkLearnt()'). 
+Lit Solver::shrinkLevel(int lev, const vec<Lit>& out_learnt, int from, int to) {
+	shrink_stamp_counter++;
+	for (int i = from; i < to; i++)
+		shrink_stamp[var(out_learnt[i])] = shrink_stamp_counter;
+	int open = to - from;
+	// Walk this level's segment of the trail backwards. Lazily enqueued literals may be on the trail after the end of
+	// their level; if any of those are needed, the walk never gets down to a single open literal, and gives up.
+	int end = lev < decisionLevel() ? trail_lim[lev] : trail.size();
+	for (int t = end - 1; t >= trail_lim[lev - 1]; t--) {
+		Var v = var(trail[t]);
+		if (shrink_stamp[v] != shrink_stamp_counter || level(v) != lev)
+			continue;
+		if (open == 1)
+			return trail[t];
+		open--;
+		CRef r = reason(v);
+		if (r == CRef_Undef || !ca.isClause(r))
+			return lit_Undef;
+		Clause & c = ca[r];
+		reasonFirst(c, v);
+		for (int k = 1; k < c.size(); k++) {
+			Var x = var(c[k]);
+			int lx = level(x);
+			if (lx == lev) {
+				if (shrink_stamp[x] != shrink_stamp_counter) {
+					shrink_stamp[x] = shrink_stamp_counter;
+					open++;
+				}
+			} else if (lx > lev || (lx > 0 && !seen[x])) {
+				return lit_Undef;
+			}
+		}
+	}
+	return lit_Undef;
+}
+
+// Remove literals from a conflicting theory clause that are implied false by the rest of the clause (as in the
+// minimization of learnt clauses). Every literal in 'ps' must be false.
+void Solver::minimizeTheoryConflict(vec<Lit>& ps) {
+	assert(!seen.contains(1));
+	analyze_toclear.clear();
+	uint32_t abstract_level = 0;
+	for (Lit l : ps) {
+		assert(value(l) == l_False);
+		seen[var(l)] = 1;
+		analyze_toclear.push(l);
+		abstract_level |= abstractLevel(var(l));
+	}
+	int i, j;
+	for (i = j = 0; i < ps.size(); i++) {
+		CRef r = reason(var(ps[i]));
+		if (r != CRef_Undef && ca.isClause(r) && level(var(ps[i])) > 0 && litRedundant(ps[i], abstract_level)) {
+			stats_theory_minimized_lits++;
+			varBumpActivity(var(ps[i]));
+		} else
+			ps[j++] = ps[i];
+	}
+	ps.shrink(i - j);
+	for (int k = 0; k < analyze_toclear.size(); k++)
+		seen[var(analyze_toclear[k])] = 0;
+}
+
 /*_________________________________________________________________________________________________
  |
  |  analyzeFinal : (p : Lit)  ->  [void]
@@ -769,6 +1044,7 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict) {
 					constructReason(trail[i]);
 				}
 				Clause& c = ca[reason(x)];
+				reasonFirst(c, x);
 				assert(var(c[0]) == x);
 				for (int j = 1; j < c.size(); j++)
 					if (level(var(c[j])) > 0)
@@ -781,15 +1057,42 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict) {
 	seen[var(p)] = 0;
 }
 
+//A cached reason clause remains a valid reason for 'p' if it still contains 'p' as one of its watched literals, and all of its other
+//literals are false and were assigned before 'p' (so that the implication graph stays acyclic).
+bool Solver::isCachedReason(Lit p, CRef cr) {
+	Clause & c = ca[cr];
+	if (c.mark() == 1)
+		return false;
+	if (c[0] != p) {
+		if (c.size() < 2 || c[1] != p)
+			return false;
+		//swapping the two watched literals leaves the watches intact
+		c[1] = c[0];
+		c[0] = p;
+	}
+	int lev = level(var(p));
+	int pos = trailIndex(var(p));
+	for (int i = 1; i < c.size(); i++) {
+		Var x = var(c[i]);
+		if (value(c[i]) != l_False || level(x) > lev || (level(x) == lev && trailIndex(x) > pos))
+			return false;
+	}
+	return true;
+}
+
 void Solver::enqueueLazy(Lit p, int lev, CRef from){
 	assert(value(p)!=l_False);
 	if(value(p)==l_True && lev < level(var(p))){
 		//then the lit was already implied, but needs to be (lazily) moved to an earlier level.
-		vardata[var(p)] = mkVarData(from, lev);
+		vardata[var(p)].reason = from;
+		vardata[var(p)].level = lev;
 	}else if(value(p)==l_Undef && lev<decisionLevel()){
 		assert(value(p) == l_Undef);
 		assigns[var(p)] = lbool(!sign(p));
-		vardata[var(p)] = mkVarData(from, lev);
+		VarData & d = vardata[var(p)];
+		d.reason = from;
+		d.level = lev;
+		d.trail_index = trail.size();
 		trail.push_(p);
 		//lazy_heap.insert(toInt(p));
 		if (hasTheory(p)) {
@@ -807,7 +1110,10 @@ void Solver::enqueueLazy(Lit p, int lev, CRef from){
 void Solver::uncheckedEnqueue(Lit p, CRef from) {
 	assert(value(p) == l_Undef);
 	assigns[var(p)] = lbool(!sign(p));
-	vardata[var(p)] = mkVarData(from, decisionLevel());
+	VarData & d = vardata[var(p)];
+	d.reason = from;
+	d.level = decisionLevel();
+	d.trail_index = trail.size();
 	trail.push_(p);
 	if (hasTheory(p)) {
 		int theoryID = getTheoryID(p);
@@ -992,6 +1298,63 @@ bool Solver::propagateTheory(vec<Lit> & conflict_out) {
  |    Post-conditions:
  |      * the propagation queue is empty, even if there was a conflict.
  |________________________________________________________________________________________________@*/
+/*_________________________________________________________________________________________________
+ |
+ |  popTheoryQueue : (cheap_only : bool)  ->  [int]
+ |
+ |  Description:
+ |    Remove the next theory to propagate from the theory queue, and return its ID.
+ |    If theory scheduling is disabled, theories are propagated in LIFO order. Otherwise, the queued theory
+ |    with the lowest propagation cost per implied literal (or conflict) is chosen, and if 'cheap_only' is set,
+ |    only theories whose average propagation cost is below 'opt_theory_schedule_cheap' are considered.
+ |    Returns -1 if no suitable theory is queued.
+ |________________________________________________________________________________________________@*/
+int Solver::popTheoryQueue(bool cheap_only) {
+	if (!theory_queue.size())
+		return -1;
+	int best = theory_queue.size() - 1;
+	if (opt_theory_schedule) {
+		double best_score = 0;
+		best = -1;
+		for (int i = theory_queue.size() - 1; i >= 0; i--) {
+			Theory * t = theories[theory_queue[i]];
+			if (cheap_only && t->getPropagationCost() > opt_theory_schedule_cheap)
+				continue;
+			double score = t->getPropagationCost() / (1 + t->getPropagationYield());
+			if (best < 0 || score < best_score) {
+				best = i;
+				best_score = score;
+			}
+		}
+		if (best < 0)
+			return -1;
+	}
+	int theoryID = theory_queue[best];
+	for (int i = best + 1; i < theory_queue.size(); i++)
+		theory_queue[i - 1] = theory_queue[i];
+	theory_queue.pop();
+	in_theory_queue[theoryID] = false;
+	return theoryID;
+}
+
+bool Solver::propagateTheory(int theoryID, vec<Lit> & conflict) {
+	Theory * t = theories[theoryID];
+	int trail_before = trail.size();
+	uint64_t start = cycleCount();
+	bool ok = t->propagateTheory(conflict);
+	uint64_t cycles = cycleCount() - start;
+	t->getPropagationProfile().add(cycles);
+	if (!opt_theory_schedule)
+		return ok;
+	double cost = (double) cycles * secondsPerCycle() * 1000.0;
+	double yield = (trail.size() - trail_before) + (ok ? 0 : 1);
+	//exponential moving averages, so that the estimates can adapt as the search moves between regions of the problem
+	static const double decay = 1.0 / 16;
+	t->getPropagationCost() += (cost - t->getPropagationCost()) * decay;
+	t->getPropagationYield() += (yield - t->getPropagationYield()) * decay;
+	return ok;
+}
+
 CRef Solver::propagate(bool propagate_theories) {
 	if (qhead == trail.size() && (!initialPropagate || decisionLevel() > 0) && (!propagate_theories || !theory_queue.size())) {//it is possible that the theory solvers need propagation, even if the sat solver has an empty queue.
 		return CRef_Undef;
@@ -1000,6 +1363,7 @@ CRef Solver::propagate(bool propagate_theories) {
 	CRef confl = CRef_Undef;
 	int num_props = 0;
 	watches.cleanAll();
+	binary_watches.cleanAll();
 	if (decisionLevel() == 0 && !propagate_theories) {
 		initialPropagate = true;//we will need to propagate this assignment to the theories at some point in the future.
 	}
@@ -1008,12 +1372,11 @@ CRef Solver::propagate(bool propagate_theories) {
 		while (qhead < trail.size()) {
 			if (opt_early_theory_prop) {
 				//propagate theories;
-				while (propagate_theories && theory_queue.size() && confl == CRef_Undef) {
+				//(if theory scheduling is enabled, expensive theories are deferred until unit propagation is complete)
+				int theoryID;
+				while (propagate_theories && confl == CRef_Undef && (theoryID = popTheoryQueue(true)) >= 0) {
 					theory_conflict.clear();
-					int theoryID = theory_queue.last();
-					theory_queue.pop();
-					in_theory_queue[theoryID] = false;
-					if (!theories[theoryID]->propagateTheory(theory_conflict)) {
+					if (!propagateTheory(theoryID, theory_conflict)) {
 						if (!addConflictClause(theory_conflict, confl)) {
 							qhead = trail.size();
 							return confl;
@@ -1023,11 +1386,31 @@ CRef Solver::propagate(bool propagate_theories) {
 			}
 			
 			Lit p = trail[qhead++];     // 'p' is enqueued fact to propagate.
+			num_props++;
+
+			// Binary clauses first: the implied literal is stored in the watcher, so the clause itself is never read.
+			// (the implied literal may be either literal of its reason clause; see reasonFirst())
+			vec<Watcher>& bws = binary_watches[p];
+			for (int k = 0; k < bws.size(); k++) {
+				Lit imp = bws[k].blocker;
+				if (value(imp) == l_Undef) {
+					uncheckedEnqueue(imp, bws[k].cref);
+				} else if (value(imp) == l_False) {
+					confl = bws[k].cref;
+					qhead = trail.size();
+					break;
+				}
+			}
+			if (confl != CRef_Undef)
+				break;
 
 			vec<Watcher>& ws = watches[p];
 			Watcher *i, *j, *end;
-			num_props++;
 			for (i = j = (Watcher*) ws, end = i + ws.size(); i != end;) {
+				// Start fetching the next watcher's clause, in case its blocker is not true either:
+				if (prefetch_watches && i + 1 != end)
+					ca.prefetch(i[1].cref);
+				
 				// Try to avoid inspecting the clause:
 				Lit blocker = i->blocker;
 				if (value(blocker) == l_True) {
@@ -1053,13 +1436,37 @@ CRef Solver::propagate(bool propagate_theories) {
 				}
 				
 				// Look for new watch:
-				for (int k = 2; k < c.size(); k++)
-					if (value(c[k]) != l_False) {
-						c[1] = c[k];
-						c[k] = false_lit;
-						watches[~c[1]].push(w);
-						goto NextClause;
-					}
+				if (c.has_pos()) {
+					// Long clause: resume from where the last search succeeded, wrapping around.
+					int sz = c.size();
+					int pos = c.savedPos();
+					if (pos >= sz)
+						pos = 2;
+					for (int k = pos; k < sz; k++)
+						if (value(c[k]) != l_False) {
+							c[1] = c[k];
+							c[k] = false_lit;
+							c.savedPos() = k;
+							watches[~c[1]].push(w);
+							goto NextClause;
+						}
+					for (int k = 2; k < pos; k++)
+						if (value(c[k]) != l_False) {
+							c[1] = c[k];
+							c[k] = false_lit;
+							c.savedPos() = k;
+							watches[~c[1]].push(w);
+							goto NextClause;
+						}
+				} else {
+					for (int k = 2; k < c.size(); k++)
+						if (value(c[k]) != l_False) {
+							c[1] = c[k];
+							c[k] = false_lit;
+							watches[~c[1]].push(w);
+							goto NextClause;
+						}
+				}
 				
 				// Did not find watch -- clause is unit under assignment:
 				*j++ = w;
@@ -1102,14 +1509,14 @@ CRef Solver::propagate(bool propagate_theories) {
 		//printf("iter %d\n",iter);
 		//printf("iter %d\n",iter);
 		//propagate theories;
-		while (propagate_theories && theory_queue.size() && (opt_early_theory_prop || qhead == trail.size())
+		//(if theory scheduling is enabled, unit propagation always runs to a fixpoint between theory propagations,
+		//so that cheap propagations and conflicts are found before the next expensive theory is propagated)
+		while (propagate_theories && theory_queue.size() && ((opt_early_theory_prop && !opt_theory_schedule) || qhead == trail.size())
 				&& confl == CRef_Undef) {
 			theory_conflict.clear();
 			//todo: ensure that the bv theory comes first, as otherwise dependent theories may have to be propagated twice...
-			int theoryID = theory_queue.last();
-			theory_queue.pop();
-			in_theory_queue[theoryID] = false;
-			if (!theories[theoryID]->propagateTheory(theory_conflict)) {
+			int theoryID = popTheoryQueue(false);
+			if (!propagateTheory(theoryID, theory_conflict)) {
 				bool has_conflict=true;
 #ifndef NDEBUG
 				for(Lit l:theory_conflict)
@@ -1202,7 +1609,257 @@ void Solver::removeSatisfied(vec<CRef>& cs) {
 	cs.shrink(i - j);
 }
 
+void Solver::removeMarked(vec<CRef>& cs) {
+	int i, j;
+	for (i = j = 0; i < cs.size(); i++) {
+		if (ca[cs[i]].mark() == 0)
+			cs[j++] = cs[i];
+	}
+	cs.shrink(i - j);
+}
+
+// Replace the clause 'cr' with the clause 'lits', which must be implied by the clause database and must subsume 'cr'.
+// The replacement inherits the learnt status, activity and origin of 'cr'. Must be called at decision level 0.
+// Returns false if the solver is now unsatisfiable.
+bool Solver::replaceClause(CRef cr, vec<Lit>& lits) {
+	assert(decisionLevel() == 0);
+	int i, j;
+	for (i = j = 0; i < lits.size(); i++) {
+		if (value(lits[i]) == l_True) {
+			//the replacement (and hence also the original clause) is satisfied at level 0
+			removeClause(cr);
+			return true;
+		} else if (value(lits[i]) != l_False)
+			lits[j++] = lits[i];
+	}
+	lits.shrink(i - j);
+	
+	if (lits.size() == 0) {
+		removeClause(cr);
+		return ok = false;
+	} else if (lits.size() == 1) {
+		removeClause(cr);
+		uncheckedEnqueue(lits[0]);
+		return ok = (propagate(false) == CRef_Undef);
+	}
+	bool learnt = ca[cr].learnt();
+	CRef cr2 = ca.alloc(lits, learnt);
+	//(allocation may have moved the clause memory)
+	Clause & c = ca[cr];
+	Clause & c2 = ca[cr2];
+	c2.setFromTheory(c.fromTheory());
+	c2.setVivified(c.vivified());
+	if (learnt) {
+		c2.activity() = c.activity();
+		learnts.push(cr2);
+	} else {
+		clauses.push(cr2);
+	}
+	attachClause(cr2);
+	removeClause(cr);
+	return true;
+}
+
+struct vivify_lt {
+	ClauseAllocator& ca;
+	vivify_lt(ClauseAllocator& ca_) :
+			ca(ca_) {
+	}
+	bool operator ()(CRef x, CRef y) {
+		return ca[x].activity() > ca[y].activity();
+	}
+};
+
+// Vivify the most active learnt clauses: for each clause (l1 ∨ ... ∨ ln), assign ~l1, ~l2, ... in turn and unit propagate
+// (without the clause itself, and without the theory solvers). If the negated prefix is conflicting, or implies one of the
+// remaining literals, the rest of the clause can be dropped; literals that are implied false by the prefix are removed.
+bool Solver::vivifyLearnts(int64_t & budget) {
+	assert(decisionLevel() == 0);
+	vec<CRef> candidates;
+	for (CRef cr : learnts) {
+		Clause & c = ca[cr];
+		if (c.mark() == 0 && !c.vivified() && c.size() > 2)
+			candidates.push(cr);
+	}
+	sort(candidates, vivify_lt(ca));
+	
+	vec<Lit> lits;
+	for (int i = 0; i < candidates.size() && budget > 0 && ok; i++) {
+		CRef cr = candidates[i];
+		if (ca[cr].mark() != 0)
+			continue;
+		if (satisfied(ca[cr])) {
+			removeClause(cr);
+			continue;
+		}
+		//detach the clause, so that it cannot propagate its own literals
+		detachClause(cr, true);
+		uint64_t props_before = propagations;
+		lits.clear();
+		const Clause & c = ca[cr];
+		for (int j = 0; j < c.size(); j++) {
+			Lit l = c[j];
+			if (value(l) == l_True) {
+				//the negation of the previous literals implies l
+				lits.push(l);
+				break;
+			} else if (value(l) == l_False) {
+				//the negation of the previous literals (or level 0) implies ~l, so l is redundant
+				continue;
+			}
+			lits.push(l);
+			newDecisionLevel();
+			uncheckedEnqueue(~l);
+			if (propagate(false) != CRef_Undef) {
+				//the negation of the literals so far is conflicting
+				break;
+			}
+		}
+		cancelUntil(0);
+		budget -= propagations - props_before;
+		attachClause(cr);
+		ca[cr].setVivified(true);
+		stats_vivified_clauses++;
+		if (lits.size() < ca[cr].size()) {
+			stats_vivified_lits += ca[cr].size() - lits.size();
+			if (!replaceClause(cr, lits))
+				return false;
+		}
+	}
+	removeMarked(learnts);
+	return ok;
+}
+
+struct subsume_lt {
+	ClauseAllocator& ca;
+	subsume_lt(ClauseAllocator& ca_) :
+			ca(ca_) {
+	}
+	bool operator ()(CRef x, CRef y) {
+		return ca[x].size() < ca[y].size();
+	}
+};
+
+// Remove clauses that are subsumed by another clause, and strengthen clauses by self-subsuming resolution.
+// If 'problem_clauses' is false, only learnt clauses are considered.
+// Learnt clauses may subsume other learnt clauses, and may strengthen (but never remove) problem clauses.
+bool Solver::subsumeClauses(int64_t & budget, bool problem_clauses) {
+	assert(decisionLevel() == 0);
+	vec<vec<CRef> > occs(nVars() * 2);
+	vec<CRef> candidates;
+	for (int k = problem_clauses ? 0 : 1; k < 2; k++) {
+		vec<CRef> & cs = k == 0 ? clauses : learnts;
+		for (CRef cr : cs) {
+			Clause & c = ca[cr];
+			if (c.mark() != 0)
+				continue;
+			candidates.push(cr);
+			for (int i = 0; i < c.size(); i++)
+				occs[toInt(c[i])].push(cr);
+		}
+	}
+	budget -= candidates.size();
+	sort(candidates, subsume_lt(ca));
+	
+	//lit_marks[l] is 1 if l is in the current subsuming clause, and 2 while l is also matched in the clause being checked
+	vec<char> lit_marks(nVars() * 2, 0);
+	vec<Lit> clause;
+	vec<Lit> strengthened;
+	for (int i = 0; i < candidates.size() && budget > 0 && ok; i++) {
+		CRef cr = candidates[i];
+		if (ca[cr].mark() != 0)
+			continue;
+		clause.clear();
+		Lit best = lit_Undef;
+		for (Lit l : ca[cr]) {
+			clause.push(l);
+			lit_marks[toInt(l)] = 1;
+			if (best == lit_Undef
+					|| occs[toInt(l)].size() + occs[toInt(~l)].size() < occs[toInt(best)].size() + occs[toInt(~best)].size())
+				best = l;
+		}
+		bool learnt = ca[cr].learnt();
+		//any clause that is subsumed or strengthened by this clause contains either 'best' or '~best'
+		for (int polarity = 0; polarity < 2 && ok; polarity++) {
+			vec<CRef> & os = occs[toInt(polarity ? ~best : best)];
+			for (int j = 0; j < os.size() && ok && ca[cr].mark() == 0; j++) {
+				CRef dr = os[j];
+				if (dr == cr || ca[dr].mark() != 0 || ca[dr].size() < clause.size())
+					continue;
+				const Clause & d = ca[dr];
+				budget -= d.size();
+				int matched = 0;
+				Lit flipped = lit_Undef;
+				int n_flipped = 0;
+				for (Lit l : d) {
+					if (lit_marks[toInt(l)] == 1) {
+						lit_marks[toInt(l)] = 2;
+						matched++;
+					} else if (lit_marks[toInt(~l)] == 1) {
+						lit_marks[toInt(~l)] = 2;
+						flipped = l;
+						n_flipped++;
+					}
+				}
+				for (Lit l : clause)
+					lit_marks[toInt(l)] = 1;
+				if (matched + n_flipped < clause.size() || n_flipped > 1) {
+					continue;
+				} else if (n_flipped == 0) {
+					//a learnt clause may be deleted later, so it may only remove other learnt clauses
+					if (d.learnt() || !learnt) {
+						stats_subsumed_clauses++;
+						removeClause(dr);
+					}
+				} else {
+					//resolving on 'flipped' yields a clause that subsumes d
+					strengthened.clear();
+					for (Lit l : d) {
+						if (l != flipped)
+							strengthened.push(l);
+					}
+					stats_strengthened_clauses++;
+					if (!replaceClause(dr, strengthened))
+						break;
+				}
+			}
+		}
+		for (Lit l : clause)
+			lit_marks[toInt(l)] = 0;
+	}
+	removeMarked(clauses);
+	removeMarked(learnts);
+	return ok;
+}
+
+// Run one round of inprocessing. Must be called at decision level 0.
+// Returns false if the solver is now unsatisfiable.
+bool Solver::inprocess() {
+	return inprocessClauses(true);
+}
+
+bool Solver::inprocessClauses(bool problem_clauses) {
+	assert(decisionLevel() == 0);
+	if (!ok || propagate(false) != CRef_Undef)
+		return ok = false;
+	double start_time = rtime(1);
+	stats_inprocess_rounds++;
+	int64_t vivify_budget = opt_inprocess_effort;
+	int64_t subsume_budget = opt_inprocess_effort;
+	if (vivifyLearnts(vivify_budget) && subsumeClauses(subsume_budget, problem_clauses)) {
+		checkGarbage();
+	}
+	stats_inprocess_time += rtime(1) - start_time;
+	return ok;
+}
+
 void Solver::rebuildOrderHeap() {
+	if (decision_heuristic == DecisionHeuristic::VMTF) {
+		//(the queue is ordered by recency rather than activity, so there is nothing to rebuild)
+		for (Var v = 0; v < nVars(); v++)
+			insertVarOrder(v);
+		return;
+	}
 	vec<Var> vs;
 	for (Var v = 0; v < nVars(); v++)
 		if (decision[v] && value(v) == l_Undef)
@@ -1495,6 +2152,17 @@ bool Solver::addConflictClause(vec<Lit> & ps, CRef & confl_out, bool permanent)
 
 	}
 	ps.shrink(i - j);
+	if (opt_theory_minimize && ps.size() > 2 && decisionLevel() > 0) {
+		bool all_false = true;
+		for (Lit l : ps) {
+			if (value(l) != l_False) {
+				all_false = false;
+				break;
+			}
+		}
+		if (all_false)
+			minimizeTheoryConflict(ps);
+	}
 /*	if(any_undef){
 		cancelUntil(0);//this is _not_ a conflict clause.
 	}*/
@@ -1693,10 +2361,40 @@ lbool Solver::search(int nof_conflicts) {
 			}
 			if (decisionLevel() == 0)
 				return l_False;
+			if (opt_lbd_restart && nof_conflicts < 0) {
+				//Restart blocking (as in Glucose): if the trail is much larger than it has recently been at conflicts,
+				//the solver may be close to a satisfying assignment, so postpone the next restart
+				trail_queue.push(trail.size());
+				if (opt_restart_blocking && conflicts > (uint64_t) opt_restart_block_conflicts && lbd_queue.full()
+						&& trail.size() > opt_restart_block_r * trail_queue.avg()) {
+					lbd_queue.clear();
+					stats_blocked_restarts++;
+				}
+			}
 			learnt_clause.clear();
 			analyze(confl, learnt_clause, backtrack_level);
+			if (decision_heuristic == DecisionHeuristic::VMTF) {
+				vmtfBumpVars();
+			} else if (decision_heuristic == DecisionHeuristic::CHB && chb_step > opt_chb_min_step) {
+				chb_step = std::max((double) opt_chb_min_step, chb_step - opt_chb_step_decay);
+			}
+			if (opt_lbd_restart && nof_conflicts < 0) {
+				unsigned int lbd = computeLBD(learnt_clause);
+				lbd_queue.push(lbd);
+				lbd_sum += lbd;
+				lbd_count++;
+			}
 			
-			cancelUntil(backtrack_level);
+			//if the learnt clause would backjump over many levels, backtrack chronologically instead, and enqueue the
+			//asserting literal (lazily) at its real level. This saves the theory solvers from backtracking and
+			//re-propagating all of the intermediate levels.
+			if (opt_chrono >= 0 && !S && learnt_clause.size() > 1 && conflicts > (uint64_t) opt_chrono_conflicts
+					&& decisionLevel() - backtrack_level > opt_chrono) {
+				stats_chrono_backtracks++;
+				cancelUntil(decisionLevel() - 1);
+			} else {
+				cancelUntil(backtrack_level);
+			}
 			
 			//this is now slightly more complicated, if there are multiple lits implied by the super solver in the current decision level:
 			//The learnt clause may not be asserting.
@@ -1710,7 +2408,7 @@ lbool Solver::search(int nof_conflicts) {
 				claBumpActivity(ca[cr]);
 
 				if (value(learnt_clause[0]) == l_Undef) {
-					uncheckedEnqueue(learnt_clause[0], cr);
+					enqueueLazy(learnt_clause[0], backtrack_level, cr);
 				} else {
 
 					assert(S);
@@ -1778,8 +2476,11 @@ lbool Solver::search(int nof_conflicts) {
 
 			
 			// NO CONFLICT
-			if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget()) {
-				// Reached bound on number of conflicts:
+			if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget()
+					|| (opt_lbd_restart && nof_conflicts < 0 && lbd_queue.full()
+							&& lbd_queue.avg() * opt_lbd_restart_k > (double) lbd_sum / lbd_count)) {
+				// Reached bound on number of conflicts (or the recent learnt clauses are of poor quality):
+				lbd_queue.clear();
 				progress_estimate = progressEstimate();
 				cancelUntil(initial_level);
 				return l_Undef;
@@ -1816,12 +2517,9 @@ lbool Solver::search(int nof_conflicts) {
 
 				int next_var_priority=INT_MIN;
 
-				//remove decided vars from order heap
-				while(!order_heap.empty() && value(order_heap.peekMin())!=l_Undef){
-					order_heap.removeMin();
-				}
-				if(!order_heap.empty()){
-					next_var_priority=priority[ order_heap.peekMin()];
+				Var next_var = peekBranchVar();
+				if(next_var!=var_Undef){
+					next_var_priority=priority[next_var];
 				}
 				/**
 				 * Give the theory solvers a chance to make decisions
@@ -1831,8 +2529,8 @@ lbool Solver::search(int nof_conflicts) {
 						int theoryID = theory_order_heap.peekMin();
 						if(opt_vsids_both && next_var_priority==theories[theory_order_heap.peekMin()]->getPriority()){
 							//give the main solver a chance to make a decision, if it has a variable with higher activity
-							if (!order_heap.empty()) {
-								Var v = order_heap.peekMin();
+							if (next_var!=var_Undef) {
+								Var v = next_var;
 								assert(value(v)==l_Undef);//because assigned lits should have been removed from queue above.
 								if(value(v)==l_Undef && activity[v]>theories[theoryID]->getActivity()){
 									stats_solver_preempted_decisions++;
@@ -1988,15 +2686,22 @@ lbool Solver::solve_() {
 		if (opt_rnd_phase) {
 			for (int i = 0; i < nVars(); i++)
 				polarity[i] = irand(random_seed, 1);
+		} else if (opt_rephase_interval > 0 && conflicts >= next_rephase) {
+			rephase();
 		}
 		if(opt_decide_theories && !opt_theory_order_vsids && opt_randomomize_theory_order){
 			randomShuffle(random_seed, decidable_theories);
 		}
 
-		status = search(rest_base * restart_first);
+		status = search(opt_lbd_restart ? -1 : rest_base * restart_first);
 		if (!withinBudget())
 			break;
 		curr_restarts++;
+		if (opt_inprocess && !S && status == l_Undef && conflicts >= last_inprocess + opt_inprocess_interval) {
+			last_inprocess = conflicts;
+			if (!inprocess())
+				status = l_False;
+		}
 		if (opt_rnd_restart && status == l_Undef) {
 			
 			for (int i = 0; i < nVars(); i++) {
@@ -2221,6 +2926,7 @@ void Solver::relocAll(ClauseAllocator& to) {
 	//
 	// for (int i = 0; i < watches.size(); i++)
 	watches.cleanAll();
+	binary_watches.cleanAll();
 	for (int v = 0; v < nVars(); v++){
 
 		for (int s = 0; s < 2; s++) {
@@ -2229,6 +2935,9 @@ void Solver::relocAll(ClauseAllocator& to) {
 			vec<Watcher>& ws = watches[p];
 			for (int j = 0; j < ws.size(); j++)
 				ca.reloc(ws[j].cref, to);
+			vec<Watcher>& bws = binary_watches[p];
+			for (int j = 0; j < bws.size(); j++)
+				ca.reloc(bws[j].cref, to);
 		}
 	}
 	// All reasons:
@@ -2240,6 +2949,17 @@ void Solver::relocAll(ClauseAllocator& to) {
 			ca.reloc(vardata[v].reason, to);
 	}
 	
+	// All cached theory reasons:
+	//
+	for (int v = 0; v < reason_cache.size(); v++) {
+		if (reason_cache[v] != CRef_Undef) {
+			if (ca[reason_cache[v]].mark() == 1)
+				reason_cache[v] = CRef_Undef;
+			else
+				ca.reloc(reason_cache[v], to);
+		}
+	}
+
 	// All learnt:
 	//
 	for (int i = 0; i < learnts.size(); i++)
@@ -2255,10 +2975,12 @@ void Solver::garbageCollect() {
 	// Initialize the next region to a size corresponding to the estimated utilization degree. This
 	// is not precise but should avoid some unnecessary reallocations for the new region:
 	ClauseAllocator to(ca.size() - ca.wasted());
+	to.saved_pos_min_size = ca.saved_pos_min_size;
 	relocAll(to);
 	if (verbosity >= 2)
-		printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n",
-				ca.size() * ClauseAllocator::Unit_Size, to.size() * ClauseAllocator::Unit_Size);
+		printf("|  Garbage collection:   %12llu bytes => %12llu bytes             |\n",
+				(unsigned long long) ca.size() * ClauseAllocator::Unit_Size,
+				(unsigned long long) to.size() * ClauseAllocator::Unit_Size);
 	to.moveTo(ca);
 }
 
@@ -28,6 +28,8 @@
 #include "mtl/Heap.h"
 #include "mtl/Alg.h"
 #include "mtl/Rnd.h"
+#include "mtl/BoundedQueue.h"
+#include "mtl/MoveToFrontQueue.h"
 #include "utils/Options.h"
 #include "core/SolverTypes.h"
 #include "core/Theory.h"
@@ -77,7 +79,11 @@ public:
 
 	void setDecisionPriority(Var v, unsigned int p) {
 		priority[v] = p;
-		if(decision[v]){
+		if (decision_heuristic == DecisionHeuristic::VMTF) {
+			if (vmtf_queue.inQueue(v))
+				vmtf_queue.setPriority(v, p);
+			insertVarOrder(v);
+		} else if(decision[v]){
 			if (order_heap.inHeap(v))
 				order_heap.decrease(v);
 			else
@@ -200,13 +206,56 @@ public:
 					stats_pure_theory_lits, pure_literal_detections, stats_pure_lit_time);
 		}
 
+		if(opt_chrono>=0){
+			printf("chrono backtracks     : %" PRIu64 "\n", stats_chrono_backtracks);
+		}
+		if(opt_lbd_restart){
+			printf("blocked restarts      : %" PRIu64 "   (avg lbd %.2f)\n", stats_blocked_restarts, lbd_count ? (double) lbd_sum / lbd_count : 0.0);
+		}
+		if(opt_rephase_interval>0){
+			printf("rephases              : %" PRIu64 "\n", stats_rephases);
+		}
+		if(opt_shrink || opt_binary_minimize || opt_theory_minimize){
+			printf("minimized literals    : %" PRIu64 " shrunk, %" PRIu64 " by binary clauses, %" PRIu64 " from theory conflicts\n",
+					stats_shrunk_lits, stats_bin_minimized_lits, stats_theory_minimized_lits);
+		}
+		if(stats_reasons_built || stats_reason_cache_hits){
+			printf("theory reasons        : %" PRIu64 " built, %" PRIu64 " reused from cache\n", stats_reasons_built,
+					stats_reason_cache_hits);
+		}
+		if(opt_inprocess && stats_inprocess_rounds){
+			printf("inprocessing          : %" PRIu64 " rounds, %f s (%" PRIu64 " clauses vivified, %" PRIu64 " lits removed, %" PRIu64 " subsumed, %" PRIu64 " strengthened, %" PRIu64 " vars eliminated)\n",
+					stats_inprocess_rounds, stats_inprocess_time, stats_vivified_clauses, stats_vivified_lits, stats_subsumed_clauses,
+					stats_strengthened_clauses, stats_inprocess_eliminated_vars);
+		}
 		if(opt_check_solution){
 			printf("Solution double-checking time (disable with -no-check-solution): %f s\n",stats_solution_checking_time);
 		}
+		if(opt_theory_schedule){
+			for (int i = 0; i < theories.size(); i++) {
+				printf("theory %d propagation : %f ms avg, %f implied lits avg\n", i, theories[i]->getPropagationCost(), theories[i]->getPropagationYield());
+			}
+		}
 		for (int i = 0; i < theories.size(); i++) {
 			theories[i]->printStats(detail_level);
 		}
 	}
+
+	//Write a snapshot of the solver's statistics (and each theory's) as a JSON object.
+	//This may be called from another thread while solving, in which case the counters are only approximately consistent.
+	void writeStatsJSON(std::ostream & out) {
+		out << "{\"solves\":" << solves << ",\"restarts\":" << starts << ",\"conflicts\":" << conflicts
+				<< ",\"decisions\":" << decisions << ",\"propagations\":" << propagations << ",\"theory_conflicts\":"
+				<< stats_theory_conflicts << ",\"theory_decisions\":" << stats_theory_decisions << ",\"vars\":" << nVars()
+				<< ",\"clauses\":" << nClauses() << ",\"learnts\":" << nLearnts();
+		out << ",\"theories\":[";
+		for (int i = 0; i < theories.size(); i++) {
+			if (i > 0)
+				out << ",";
+			theories[i]->writeStatsJSON(out);
+		}
+		out << "]}";
+	}
 	
 	void writeTheoryWitness(std::ostream& write_to) {
 		if (!ok) {
@@ -243,20 +292,20 @@ public:
 	}
 	
 	bool hasTheory(Var v) {
-		return theory_vars[v].isTheoryVar;
+		return vardata[v].theory;
 	}
 	bool hasTheory(Lit l) {
-		return theory_vars[var(l)].isTheoryVar;
+		return vardata[var(l)].theory;
 	}
 	int getTheoryID(Var v) {
-		return theory_vars[v].theory - 1;
+		return vardata[v].theory - 1;
 	}
 	int getTheoryID(Lit l) {
-		return theory_vars[var(l)].theory - 1;
+		return vardata[var(l)].theory - 1;
 	}
 	Var getTheoryVar(Var v) {
 		assert(hasTheory(v));
-		return (Var) theory_vars[v].theory_var;
+		return theory_vars[v];
 	}
 	
 	//Translate a literal into its corresponding theory literal (if it has a theory literal)
@@ -283,8 +332,8 @@ public:
 			exit(1);
 		}
 		assert(!hasTheory(solverVar));
-		theory_vars[solverVar].theory = theory + 1;
-		theory_vars[solverVar].theory_var = theoryVar;
+		vardata[solverVar].theory = theory + 1;
+		theory_vars[solverVar] = theoryVar;
 		all_theory_vars.push(solverVar);
 		assert(hasTheory(solverVar));
 		assert(getTheoryID(solverVar) == theory);
@@ -297,7 +346,7 @@ public:
 	
 	void remapTheoryVar(Var solverVar, Var newTheoryVar) {
 		assert(hasTheory(solverVar));
-		theory_vars[solverVar].theory_var = newTheoryVar;
+		theory_vars[solverVar] = newTheoryVar;
 	}
 	
 	void preprocess(){
@@ -317,6 +366,15 @@ public:
 		assert(isTheoryCause(cr));
 		assert(!ca.isClause(cr));
 		assert(cr != CRef_Undef);
+		if (opt_theory_reason_cache) {
+			CRef cached = reason_cache[var(p)];
+			if (cached != CRef_Undef && isCachedReason(p, cached)) {
+				stats_reason_cache_hits++;
+				vardata[var(p)].reason = cached;
+				return cached;
+			}
+		}
+		stats_reasons_built++;
 		int trail_pos = trail.size();
 		int t = getTheory(cr);
 		assert(hasTheory(p));
@@ -347,7 +405,9 @@ public:
 
 		int lev = decisionLevel();
 		CRef reason = attachReasonClause(p,theory_reason);
-		vardata[var(p)] = mkVarData(reason, level(var(p)));
+		vardata[var(p)].reason = reason;
+		if (opt_theory_reason_cache)
+			reason_cache[var(p)] = reason;
 		assert(decisionLevel()==lev);//ensure no backtracking happened while adding this clause!
 		assert(ok);
 
@@ -382,6 +442,7 @@ public:
 	// Solving:
 	//
 	bool simplify();                        // Removes already satisfied clauses.
+	virtual bool inprocess();               // Simplify the clause database between restarts (vivification, subsumption).
 	virtual bool solve(const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions.
 	virtual lbool solveLimited(const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions (With resource constraints).
 	virtual bool solve();                        // Search without assumptions.
@@ -526,6 +587,7 @@ public:
 	bool rnd_pol;            // Use random polarities for branching heuristics.
 	bool rnd_init_act;       // Initialize variable activities with a small random value.
 	double garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
+	bool prefetch_watches;     // Prefetch the clause of the next watcher during unit propagation.
 	
 	int restart_first; // The initial restart limit.                                                                (default 100)
 	double restart_inc; // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
@@ -549,20 +611,36 @@ public:
 	int consecutive_theory_conflicts=0;
 	uint64_t next_theory_decision = 0;
 	uint64_t n_theory_decision_rounds=0;
+	uint64_t stats_chrono_backtracks=0;
+	uint64_t stats_blocked_restarts=0;
+	uint64_t stats_rephases=0;
+	uint64_t stats_shrunk_lits=0;
+	uint64_t stats_bin_minimized_lits=0;
+	uint64_t stats_theory_minimized_lits=0;
+	uint64_t stats_reasons_built=0;
+	uint64_t stats_reason_cache_hits=0;
+	uint64_t stats_inprocess_rounds=0;
+	uint64_t stats_vivified_clauses=0;
+	uint64_t stats_vivified_lits=0;
+	uint64_t stats_subsumed_clauses=0;
+	uint64_t stats_strengthened_clauses=0;
+	uint64_t stats_inprocess_eliminated_vars=0;
+	double stats_inprocess_time=0;
 
 	//Var last_dec=var_Undef;
 protected:
 	
 	// Helper structures:
 	//
+	//The per-variable state that is read and written whenever a variable is assigned or analyzed, packed into 16 bytes so that a
+	//cache line holds 4 variables. Assignments themselves are kept separately in 'assigns' (1 byte each), which 'propagate()'
+	//reads far more often than anything else; colder per-variable data (activity, polarity, theory variables) lives in its own vectors.
 	struct VarData {
 		CRef reason;
 		int level;
+		int trail_index; //position of the variable in 'trail', while it is assigned
+		unsigned int theory; //1 + the theory this variable belongs to, or 0 if it is not a theory variable
 	};
-	static inline VarData mkVarData(CRef cr, int l) {
-		VarData d = { cr, l };
-		return d;
-	}
 	
 	struct Watcher {
 		CRef cref;
@@ -629,23 +707,6 @@ protected:
 			}
 		};
 
-	struct TheoryData {
-		union {
-			struct {
-				unsigned int theory ;
-				unsigned int theory_var;//these were previously packed together into a 32bit int, but that has proved insufficient in practice.
-			};
-			unsigned int isTheoryVar; //true if non-zero - this property is ensured by adding 1 to theory_var
-		};
-		TheoryData() :
-				isTheoryVar(0) {
-		}
-		TheoryData(unsigned int theory, unsigned int theory_lit) :
-				theory(theory), theory_var(theory_lit) {
-			
-		}
-	};
-
 	// Solver state:
 	//
 	bool ok;            // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
@@ -655,22 +716,46 @@ protected:
 	vec<double> activity;         // A heuristic measurement of the activity of a variable.
 	double var_inc;          // Amount to bump next variable with.
 	OccLists<Lit, vec<Watcher>, WatcherDeleted> watches; // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+	OccLists<Lit, vec<Watcher>, WatcherDeleted> binary_watches; // As 'watches', but for binary clauses only; each watcher's blocker is the other literal of the clause.
 	int theoryConflict=-1;
 	vec<lbool> assigns;          // The current assignments.
 	vec<char> polarity;         // The preferred polarity of each variable.
+	vec<char> original_polarity; // The initial (or user provided) polarity of each variable, restored by rephasing.
+	vec<lbool> target_phase;    // The assignment of each variable in the largest trail since the last rephase (or l_Undef).
+	vec<lbool> best_phase;      // The assignment of each variable in the largest trail since the best phases were last restored.
+	int target_assigned = 0;    // Size of the trail that 'target_phase' was recorded from.
+	int best_assigned = 0;      // Size of the trail that 'best_phase' was recorded from.
+	uint64_t rephases = 0;
+	uint64_t next_rephase = 0;  // Number of conflicts at which the saved phases will next be reset.
+	BoundedQueue<unsigned int> lbd_queue;   // LBDs of the most recent learnt clauses (for dynamic restarts).
+	BoundedQueue<unsigned int> trail_queue; // Trail sizes at the most recent conflicts (for restart blocking).
+	uint64_t lbd_sum = 0;       // Sum of the LBDs of all learnt clauses, and the number of learnt clauses they were measured over.
+	uint64_t lbd_count = 0;
+	vec<uint64_t> lbd_stamp;    // (Temporary used by 'computeLBD()', indexed by decision level.)
+	uint64_t lbd_stamp_counter = 0;
+	vec<uint64_t> shrink_stamp; // (Temporary used by 'shrinkLevel()', indexed by variable.)
+	uint64_t shrink_stamp_counter = 0;
 	vec<char> decision;         // Declares if a variable is eligible for selection in the decision heuristic.
 	vec<int> priority;		  // Static, lexicographic heuristic. Larger values are higher priority (decided first)
-	vec<TheoryData> theory_vars;
+	vec<Var> theory_vars;      // The theory's own variable for each theory variable (its theory is stored in 'vardata').
 	vec<Lit> to_analyze;
 	vec<Lit> to_reenqueue;
 	vec<Lit> trail;            // Assignment stack; stores all assigments made in the order they were made.
 	vec<int> trail_lim;        // Separator indices for different decision levels in 'trail'.
-	vec<VarData> vardata;          // Stores reason and level for each variable.
+	vec<VarData> vardata;          // Stores reason, level, trail position and theory for each variable.
+	vec<CRef> reason_cache;        // The last reason clause constructed by a theory for each variable (see 'constructReason()').
 	int qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
 	int simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
 	int64_t simpDB_props;   // Remaining number of propagations that must be made before next execution of 'simplify()'.
+	uint64_t last_inprocess=0; // Number of conflicts at the last execution of 'inprocess()'.
 	vec<Lit> assumptions;      // Current set of assumptions provided to solve by the user.
 	Heap<VarOrderLt> order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+	DecisionHeuristic decision_heuristic;
+	MoveToFrontQueue vmtf_queue;       // Replaces 'order_heap' if the decision heuristic is VMTF.
+	vec<Var> vmtf_bumped;              // Variables bumped during the current conflict analysis (moved to the front together).
+	vec<uint64_t> chb_last_conflict;   // CHB: the last conflict that each variable took part in.
+	double chb_step;                   // CHB: the current step size of the score updates.
+	uint64_t chb_backtrack_conflicts = 0; // CHB: the number of conflicts at the last backtrack.
 	double theory_inc;
 	double theory_decay;
 	Heap<TheoryOrderLt> theory_order_heap;
@@ -705,6 +790,9 @@ protected:
 	//
 	void insertVarOrder(Var x);                               // Insert a variable in the decision order priority queue.
 	Lit pickBranchLit();                                                      // Return the next decision variable.
+	Var peekBranchVar();                                      // Return the next unassigned variable in the decision order, without deciding it (or var_Undef).
+	void vmtfBumpVars();                                      // Move the variables bumped during conflict analysis to the front of the VMTF queue.
+	void chbUnassign(Var x, double multiplier);               // Reward a variable that is being unassigned, by the CHB heuristic.
 public:
 	void instantiateLazyDecision(Lit l, int atLevel, CRef reason);
 	Lit theoryDecisionLit(int theoryID){
@@ -733,6 +821,8 @@ protected:
 
 
 	CRef propagate(bool propagate_theories = true);    // Perform unit propagation. Returns possibly conflicting clause.
+	int popTheoryQueue(bool cheap_only);                // Remove the next theory to propagate from the theory queue, or return -1.
+	bool propagateTheory(int theoryID, vec<Lit> & conflict); // Propagate a single theory, updating its cost and yield estimates.
 	void enqueueTheory(Lit l);
 	bool propagateTheory(vec<Lit> & conflict);
 	bool solveTheory(vec<Lit> & conflict_out);
@@ -756,10 +846,22 @@ protected:
 	void analyzeFinal(CRef confl, Lit skip_lit, vec<Lit>& out_conflict);
 	void analyzeFinal(Lit p, vec<Lit>& out_conflict); // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
 	bool litRedundant(Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
-	lbool search(int nof_conflicts);                                     // Search for a given number of conflicts.
+	void binaryMinimize(vec<Lit>& out_learnt);                     // Remove learnt literals by resolution with binary clauses (helper method for 'analyze()')
+	void shrinkLearnt(vec<Lit>& out_learnt);                       // Replace the learnt literals of each level by their UIP, where possible (helper method for 'analyze()')
+	Lit shrinkLevel(int lev, const vec<Lit>& out_learnt, int from, int to); // (helper method for 'shrinkLearnt()')
+	void minimizeTheoryConflict(vec<Lit>& ps);                     // Remove literals implied by the rest of a conflicting theory clause.
+	lbool search(int nof_conflicts);                                     // Search for a given number of conflicts (or until a dynamic restart, if negative and lbd-restart is set).
+	unsigned int computeLBD(const vec<Lit>& lits);                  // Number of distinct decision levels among 'lits'.
+	void updatePhases();                                           // Record the target/best phases from the trail, if it is the largest yet.
+	void rephase();                                                // Reset the saved phases (to the best, original, inverted or random phases).
 	lbool solve_();                                           // Main solve method (assumptions given in 'assumptions').
 	void reduceDB();                                                      // Reduce the set of learnt clauses.
 	void removeSatisfied(vec<CRef>& cs);                           // Shrink 'cs' to contain only non-satisfied clauses.
+	bool vivifyLearnts(int64_t& budget);                          // Shorten learnt clauses by propagating the negation of their literals.
+	bool subsumeClauses(int64_t& budget, bool problem_clauses);   // Remove subsumed clauses, and strengthen clauses by self-subsuming resolution.
+	bool inprocessClauses(bool problem_clauses);                   // Vivify and subsume clauses (if 'problem_clauses' is false, only learnt clauses are modified).
+	bool replaceClause(CRef cr, vec<Lit>& lits);                   // Replace a clause by a (shorter) clause implied by the clause database.
+	void removeMarked(vec<CRef>& cs);                              // Shrink 'cs' to contain only clauses that have not been removed.
 	void rebuildOrderHeap();
 	void rebuildTheoryOrderHeap();
 	// Maintaining Variable/Clause activity:
@@ -812,6 +914,9 @@ protected:
 	void detachClause(CRef cr, bool strict = false); // Detach a clause to watcher lists.
 	void removeClause(CRef cr);               // Detach and free a clause.
 	bool locked(const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
+	Lit lockedLit(const Clause& c) const; // Returns the literal that the clause is the reason for in the current state (or lit_Undef).
+	void reasonFirst(Clause& c, Var x); // Move the literal on 'x' to the front of its reason clause 'c'.
+	bool isCachedReason(Lit p, CRef cr); // True if the clause 'cr' can serve as the reason for 'p' in the current assignment.
 	bool satisfied(const Clause& c) const; // Returns TRUE if a clause is satisfied in the current state.
 			
 	void relocAll(ClauseAllocator& to);
@@ -823,6 +928,7 @@ public:
 			
 	CRef reason(Var x) const;
 	int level(Var x) const;
+	int trailIndex(Var x) const;
 	double progressEstimate() const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
 
 	 bool isConstant(Var v)const{
@@ -935,9 +1041,19 @@ inline CRef Solver::reason(Var x) const {
 inline int Solver::level(Var x) const {
 	return vardata[x].level;
 }
+inline int Solver::trailIndex(Var x) const {
+	return vardata[x].trail_index;
+}
 
 inline void Solver::insertVarOrder(Var x) {
-	if (!order_heap.inHeap(x) && decision[x])
+	if (decision_heuristic == DecisionHeuristic::VMTF) {
+		if (!decision[x])
+			return;
+		if (!vmtf_queue.inQueue(x))
+			vmtf_queue.insert(x, priority[x]);
+		if (value(x) == l_Undef)
+			vmtf_queue.touch(x);
+	} else if (!order_heap.inHeap(x) && decision[x])
 		order_heap.insert(x);
 }
 
@@ -948,6 +1064,11 @@ inline void Solver::varBumpActivity(Var v) {
 	varBumpActivity(v, var_inc);
 }
 inline void Solver::varBumpActivity(Var v, double inc) {
+	if (decision_heuristic == DecisionHeuristic::CHB) {
+		//CHB scores are only updated as variables are unassigned (see chbUnassign())
+		chb_last_conflict[v] = conflicts;
+		return;
+	}
 	if ((activity[v] += inc) > 1e100) {
 		// Rescale:
 		for (int i = 0; i < nVars(); i++)
@@ -962,11 +1083,20 @@ inline void Solver::varBumpActivity(Var v, double inc) {
 	}
 	
 	// Update order_heap with respect to new activity:
-	if (order_heap.inHeap(v))
+	if (decision_heuristic == DecisionHeuristic::VMTF) {
+		//(the activity is still maintained, for comparison with theory activities)
+		vmtf_bumped.push(v);
+	} else if (order_heap.inHeap(v))
 		order_heap.decrease(v);
 
 
 }
+inline void Solver::chbUnassign(Var x, double multiplier) {
+	double reward = multiplier / (double) (conflicts - chb_last_conflict[x] + 1);
+	activity[x] = (1 - chb_step) * activity[x] + chb_step * reward;
+	if (order_heap.inHeap(x))
+		order_heap.update(x);
+}
 
 
 inline void Solver::claDecayActivity() {
@@ -1019,12 +1149,27 @@ inline bool Solver::addClause(Lit p, Lit q, Lit r) {
 	add_tmp.push(r);
 	return addClause_(add_tmp);
 }
+inline Lit Solver::lockedLit(const Clause& c) const {
+	//binary clauses are propagated without being read (see propagate()), so they may imply either of their literals
+	for (int i = 0; i < (c.size() == 2 ? 2 : 1); i++) {
+		CRef r = reason(var(c[i]));
+		if (value(c[i]) == l_True && ca.isClause(r) && ca.lea(r) == &c)
+			return c[i];
+	}
+	return lit_Undef;
+}
 inline bool Solver::locked(const Clause& c) const {
-	CRef r = reason(var(c[0]));
-	bool isClause = ca.isClause(r);
-	if (!isClause)
-		return false;
-	return value(c[0]) == l_True && ca.isClause(reason(var(c[0]))) && ca.lea(reason(var(c[0]))) == &c;
+	return lockedLit(c) != lit_Undef;
+}
+inline void Solver::reasonFirst(Clause& c, Var x) {
+	//(only binary clauses can have their implied literal out of place)
+	if (var(c[0]) != x) {
+		assert(c.size() == 2);
+		assert(var(c[1]) == x);
+		Lit tmp = c[0];
+		c[0] = c[1];
+		c[1] = tmp;
+	}
 }
 inline void Solver::newDecisionLevel() {
 	trail_lim.push(trail.size());
@@ -1070,6 +1215,7 @@ inline int Solver::nFreeVars() const {
 }
 inline void Solver::setPolarity(Var v, bool b) {
 	polarity[v] = b;
+	original_polarity[v] = b;
 }
 inline void Solver::setDecisionVar(Var v, bool b) {
 	if (b && !decision[v])
@@ -1078,6 +1224,8 @@ inline void Solver::setDecisionVar(Var v, bool b) {
 		dec_vars--;
 	
 	decision[v] = b;
+	if (!b && decision_heuristic == DecisionHeuristic::VMTF && vmtf_queue.inQueue(v))
+		vmtf_queue.remove(v);
 	insertVarOrder(v);
 }
 inline void Solver::setConfBudget(int64_t x) {
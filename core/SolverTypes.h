@@ -25,6 +25,7 @@
 #define Minisat_SolverTypes_h
 
 #include <assert.h>
+#include <algorithm>
 
 #include "mtl/IntTypes.h"
 #include "mtl/Alg.h"
@@ -177,26 +178,31 @@ class Clause {
 		unsigned has_extra :1;
 		unsigned reloced :1;
 		unsigned fromTheory :1;
-		unsigned size :26;
+		unsigned vivified :1;
+		unsigned has_pos :1;
+		unsigned size :24;
 	} header;
 	union {
 		Lit lit;
 		float act;
 		uint32_t abs;
-		CRef rel;
+		uint32_t pos;
+		uint32_t rel;//the relocation occupies the first sizeof(CRef)/sizeof(uint32_t) words
 	} data[0];
 
 	friend class ClauseAllocator;
 
 	// NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
 	template<class V>
-	Clause(const V& ps, bool use_extra, bool learnt) {
+	Clause(const V& ps, bool use_extra, bool learnt, bool use_pos) {
 		header.mark = 0;
 		header.learnt = learnt;
 		header.has_extra = use_extra;
 		header.reloced = 0;
 		header.size = ps.size();
 		header.fromTheory = 0;
+		header.vivified = 0;
+		header.has_pos = use_pos;
 		
 		for (int i = 0; i < ps.size(); i++)
 			data[i].lit = ps[i];
@@ -207,6 +213,8 @@ class Clause {
 			else
 				calcAbstraction();
 		}
+		if (header.has_pos)
+			data[header.size + header.has_extra].pos = 2;
 	}
 	
 public:
@@ -224,6 +232,8 @@ public:
 	//This is NOT safe. Only use this if it is guaranteed that the clause has enough extra allocated space
 	void grow(int i) {
 		assert(i >= 0);
+		if (header.has_pos)
+			data[header.size + header.has_extra + i] = data[header.size + header.has_extra];
 		if (header.has_extra)
 			data[header.size + i] = data[header.size];
 		header.size += i;
@@ -232,6 +242,8 @@ public:
 		assert(i <= size());
 		if (header.has_extra)
 			data[header.size - i] = data[header.size];
+		if (header.has_pos)
+			data[header.size + header.has_extra - i] = data[header.size + header.has_extra];
 		header.size -= i;
 	}
 	void pop() {
@@ -243,6 +255,9 @@ public:
 	bool has_extra() const {
 		return header.has_extra;
 	}
+	bool has_pos() const {
+		return header.has_pos;
+	}
 	uint32_t mark() const {
 		return header.mark;
 	}
@@ -261,15 +276,27 @@ public:
 		header.fromTheory = t;
 	}
 	
+	//True if this clause has already been vivified (or was produced by vivification)
+	bool vivified() const {
+		return header.vivified;
+	}
+	
+	void setVivified(bool v) {
+		header.vivified = v;
+	}
+	
 	bool reloced() const {
 		return header.reloced;
 	}
 	CRef relocation() const {
-		return data[0].rel;
+		CRef c;
+		memcpy(&c, &data[0], sizeof(CRef));
+		return c;
 	}
+	//Overwrites the first literals of the clause (and, for short clauses, possibly its extra field)
 	void relocate(CRef c) {
 		header.reloced = 1;
-		data[0].rel = c;
+		memcpy(&data[0], &c, sizeof(CRef));
 	}
 	
 	// NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
@@ -292,6 +319,13 @@ public:
 		assert(header.has_extra);
 		return data[header.size].abs;
 	}
+	//Where propagate() last found a replacement watch, in [2, size()) (see Gent, "Optimal Implementation of Watched
+	//Literals and More General Techniques"). This is only a hint: code that rearranges or shrinks the clause need not
+	//maintain it, so it is clamped on use.
+	uint32_t& savedPos() {
+		assert(header.has_pos);
+		return data[header.size + header.has_extra].pos;
+	}
 	
 	Lit subsumes(const Clause& other) const;
 	void strengthen(Lit p);
@@ -311,11 +345,15 @@ public:
 
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator: public RegionAllocator<uint32_t> {
-	static int clauseWord32Size(int size, bool has_extra) {
-		return (sizeof(Clause) + (sizeof(Lit) * (size + (int) has_extra))) / sizeof(uint32_t);
+	static int clauseWord32Size(int size, bool has_extra, bool has_pos) {
+		//always leave enough room to store a relocation
+		int words = std::max(size + (int) has_extra + (int) has_pos, (int) (sizeof(CRef) / sizeof(uint32_t)));
+		return (sizeof(Clause) + (sizeof(Lit) * words)) / sizeof(uint32_t);
 	}
 public:
 	bool extra_clause_field;
+	//Clauses with at least this many literals store a saved search position for propagate() (0 to disable)
+	int saved_pos_min_size;
 	CRef marker_refs;
 
 	CRef makeMarkerReference() {
@@ -326,15 +364,16 @@ public:
 		return cr < marker_refs;
 	}
 	
-	ClauseAllocator(uint32_t start_cap) :
-			RegionAllocator<uint32_t>(start_cap), extra_clause_field(false), marker_refs(CRef_Undef) {
+	ClauseAllocator(Ref start_cap) :
+			RegionAllocator<uint32_t>(start_cap), extra_clause_field(false), saved_pos_min_size(0), marker_refs(CRef_Undef) {
 	}
 	ClauseAllocator() :
-			extra_clause_field(false), marker_refs(CRef_Undef) {
+			extra_clause_field(false), saved_pos_min_size(0), marker_refs(CRef_Undef) {
 	}
 	
 	void moveTo(ClauseAllocator& to) {
 		to.extra_clause_field = extra_clause_field;
+		to.saved_pos_min_size = saved_pos_min_size;
 		RegionAllocator<uint32_t>::moveTo(to);
 	}
 	
@@ -343,9 +382,10 @@ public:
 		assert(sizeof(Lit) == sizeof(uint32_t));
 		assert(sizeof(float) == sizeof(uint32_t));
 		bool use_extra = learnt | extra_clause_field;
+		bool use_pos = saved_pos_min_size > 0 && ps.size() >= saved_pos_min_size;
 		
-		CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
-		new (lea(cid)) Clause(ps, use_extra, learnt);
+		CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra, use_pos));
+		new (lea(cid)) Clause(ps, use_extra, learnt, use_pos);
 		
 		return cid;
 	}
@@ -363,6 +403,12 @@ public:
 	const Clause* lea(Ref r) const {
 		return (Clause*) RegionAllocator<uint32_t>::lea(r);
 	}
+	//Hint that the header and first literals of 'r' will be read soon.
+	void prefetch(Ref r) const {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(lea(r));
+#endif
+	}
 	Ref ael(const Clause* t) {
 		return RegionAllocator<uint32_t>::ael((uint32_t*) t);
 	}
@@ -373,7 +419,7 @@ public:
 			return;
 		}
 		Clause& c = operator[](cid);
-		RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+		RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra(), c.has_pos()));
 	}
 	
 	void reloc(CRef& cr, ClauseAllocator& to) {
@@ -388,8 +434,8 @@ public:
 		}
 		
 		cr = to.alloc(c, c.learnt());
-		c.relocate(cr);
 		to[cr].setFromTheory(c.fromTheory());
+		to[cr].setVivified(c.vivified());
 		// Copy extra data-fields: 
 		// (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
 		to[cr].mark(c.mark());
@@ -397,6 +443,10 @@ public:
 			to[cr].activity() = c.activity();
 		else if (to[cr].has_extra())
 			to[cr].calcAbstraction();
+		if (to[cr].has_pos() && c.has_pos())
+			to[cr].savedPos() = c.savedPos();
+		//(only after copying the extra fields, which relocate() may overwrite)
+		c.relocate(cr);
 	}
 };
 
@@ -27,6 +27,7 @@
 #include "mtl/Alg.h"
 #include "utils/Options.h"
 #include "core/SolverTypes.h"
+#include "utils/Profile.h"
 #include <ostream>
 namespace Monosat {
 /**
@@ -35,6 +36,12 @@ namespace Monosat {
 class Theory {
 	int priority=0;
 	double activity=0;
+	//running averages of the time (in ms) and the number of implied literals and conflicts of each call to propagateTheory,
+	//used by the solver to schedule cheap theories before expensive ones
+	double propagation_cost=0;
+	double propagation_yield=0;
+	//cycles spent in (and number of calls to) propagateTheory, as measured by the solver
+	ProfileCounter propagation_profile;
 public:
 	virtual ~Theory() {
 	}
@@ -53,6 +60,16 @@ public:
     	activity=p;
     }
 
+    double & getPropagationCost(){
+		return propagation_cost;
+	}
+    double & getPropagationYield(){
+		return propagation_yield;
+	}
+    ProfileCounter & getPropagationProfile(){
+    	return propagation_profile;
+    }
+
 	virtual int getTheoryIndex()=0;
 	virtual void setTheoryIndex(int id)=0;
 	virtual void backtrackUntil(int untilLevel)=0;
@@ -91,6 +108,13 @@ public:
 	}
 	virtual void printStats(int detailLevel = 0) {
 		
+	}
+	//Write this theory's statistics as a single JSON object.
+	//May be called from another thread while the solver is running, in which case the counters are best-effort.
+	virtual void writeStatsJSON(std::ostream & out) {
+		out << "{\"index\":" << getTheoryIndex() << ",\"propagate\":";
+		getPropagationProfile().writeJSON(out);
+		out << "}";
 	}
 	virtual bool check_propagated(){
 		return true;
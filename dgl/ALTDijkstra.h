@@ -0,0 +1,410 @@
+/****************************************************************************************[ALTDijkstra.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef ALTDIJKSTRA_H_
+#define ALTDIJKSTRA_H_
+
+#include <vector>
+#include "alg/Heap.h"
+#include "DynamicGraph.h"
+#include "Reach.h"
+#include "Distance.h"
+namespace dgl {
+
+/**
+ * Lower bounds on the distance from every node to each of a small set of target nodes,
+ * computed by a backwards Dijkstra from each target.
+ * The bounds remain valid for as long as the graph only loses edges (or edge weights only increase)
+ * relative to the graph they were computed on; the owner is responsible for only calling
+ * update() at points where that holds for the rest of the search (e.g., at decision level 0).
+ * If nodes or edges are added to the graph, the bounds are invalidated until the next update().
+ */
+template<typename Weight = long, bool undirected = false>
+class ALTLandmarks {
+public:
+	DynamicGraph<Weight> & g;
+	std::vector<int> targets;
+	//to_target[i][u] is the distance from u to targets[i] in the graph as of the last update().
+	std::vector<std::vector<Weight>> to_target;
+private:
+	int computed_nodes = -1;
+	int computed_edges = -1;
+	int computed_targets = 0;
+	int last_modification = -1;
+
+	std::vector<Weight> dist;
+	struct DistCmp {
+		std::vector<Weight> & _dist;
+		bool operator()(int a, int b) const {
+			return _dist[a] < _dist[b];
+		}
+		DistCmp(std::vector<Weight> & d) :
+				_dist(d) {
+		}
+		;
+	};
+	Heap<DistCmp> q;
+
+	Weight & inf() {
+		return Distance<Weight>::INF;
+	}
+
+	void computeDistancesTo(int target) {
+		q.clear();
+		for (int i = 0; i < g.nodes(); i++)
+			dist[i] = inf();
+		dist[target] = 0;
+		q.insert(target);
+		while (q.size()) {
+			int u = q.removeMin();
+			for (int i = 0; i < g.nIncoming(u, undirected); i++) {
+				int edgeID = g.incoming(u, i, undirected).id;
+				if (!g.edgeEnabled(edgeID))
+					continue;
+				int v = g.incoming(u, i, undirected).node;
+				Weight alt = dist[u] + g.getWeight(edgeID);
+				if (alt < dist[v]) {
+					dist[v] = alt;
+					if (!q.inHeap(v))
+						q.insert(v);
+					else
+						q.decrease(v);
+				}
+			}
+		}
+	}
+
+public:
+	long stats_updates = 0;
+
+	ALTLandmarks(DynamicGraph<Weight> & graph) :
+			g(graph), q(DistCmp(dist)) {
+	}
+
+	int nTargets() const {
+		return targets.size();
+	}
+	int getTarget(int i) const {
+		return targets[i];
+	}
+	int addTarget(int t) {
+		for (int i = 0; i < targets.size(); i++) {
+			if (targets[i] == t)
+				return i;
+		}
+		targets.push_back(t);
+		return targets.size() - 1;
+	}
+
+	//True if the bounds cover every target and still apply to the graph as it currently is.
+	bool valid() const {
+		return computed_targets == targets.size() && computed_nodes == g.nodes() && computed_edges == g.edges();
+	}
+
+	//A lower bound on the distance from u to targets[i], or inf() if u cannot reach that target.
+	Weight & lowerBound(int u, int i) {
+		assert(valid());
+		return to_target[i][u];
+	}
+
+	//Recompute the bounds against the current state of the graph.
+	void update() {
+		if (valid() && last_modification == g.modifications)
+			return;
+		stats_updates++;
+		dist.resize(g.nodes());
+		to_target.resize(targets.size());
+		for (int i = 0; i < targets.size(); i++) {
+			computeDistancesTo(targets[i]);
+			to_target[i] = dist;
+		}
+		computed_nodes = g.nodes();
+		computed_edges = g.edges();
+		computed_targets = targets.size();
+		last_modification = g.modifications;
+	}
+};
+
+/**
+ * Goal-directed (A*) shortest paths from a single source to the targets of an ALTLandmarks object.
+ * While the landmark bounds are valid, the search is guided by them, never expands nodes that cannot
+ * reach any target, and stops as soon as every target is settled; otherwise it falls back on a
+ * Dijkstra search that still stops early once the targets are settled.
+ *
+ * Distances (and shortest path trees) are only exact for the targets and for nodes on their shortest paths;
+ * other nodes report an upper bound on their distance (or unreachable, if the search did not reach them).
+ */
+template<typename Weight = long, class Status = typename Distance<Weight>::NullStatus, bool undirected = false>
+class ALTDijkstra: public Distance<Weight> {
+	using Distance<Weight>::inf;
+	using Distance<Weight>::unreachable;
+public:
+	DynamicGraph<Weight> & g;
+	ALTLandmarks<Weight, undirected> & landmarks;
+	Status & status;
+	int reportPolarity;
+
+	int last_modification = -1;
+	int last_addition = 0;
+	int last_deletion = 0;
+	int last_edge_inc = 0;
+	int last_edge_dec = 0;
+	int history_qhead = 0;
+
+	int last_history_clear = 0;
+	int history_id = -1;
+
+	int source;
+	int searched_targets = 0;
+	std::vector<Weight> dist;
+	std::vector<Weight> h;		//landmark lower bound from each touched node to the closest target
+	std::vector<Weight> key;	//dist + h
+	std::vector<int> prev;
+	std::vector<int> touched;
+	std::vector<char> is_target;
+	struct DistCmp {
+		std::vector<Weight> & _dist;
+		bool operator()(int a, int b) const {
+			return _dist[a] < _dist[b];
+		}
+		DistCmp(std::vector<Weight> & d) :
+				_dist(d) {
+		}
+		;
+	};
+	Heap<DistCmp> q;
+
+public:
+
+	int stats_full_updates = 0;
+	int stats_skip_deletes = 0;
+	long stats_nodes_settled = 0;
+
+	ALTDijkstra(int s, DynamicGraph<Weight> & graph, ALTLandmarks<Weight, undirected> & landmarks, Status & status,
+			int reportPolarity = 0) :
+			g(graph), landmarks(landmarks), status(status), reportPolarity(reportPolarity), source(s), q(DistCmp(key)) {
+		history_id = g.addHistoryConsumer();
+
+	}
+
+	ALTDijkstra(int s, DynamicGraph<Weight> & graph, ALTLandmarks<Weight, undirected> & landmarks, int reportPolarity = 0) :
+			g(graph), landmarks(landmarks), status(Distance<Weight>::nullStatus), reportPolarity(reportPolarity), source(
+					s), q(DistCmp(key)) {
+		history_id = g.addHistoryConsumer();
+
+	}
+
+	void setSource(int s) {
+		source = s;
+		last_modification = -1;
+		last_addition = -1;
+		last_deletion = -1;
+	}
+	int getSource() {
+		return source;
+	}
+
+	void drawFull() {
+
+	}
+	long num_updates = 0;
+	int numUpdates() const {
+		return num_updates;
+	}
+private:
+	//The smallest lower bound from u to any target (or inf(), if u cannot reach any of them).
+	Weight heuristic(int u, bool use_landmarks) {
+		if (!use_landmarks)
+			return 0;
+		Weight best = inf();
+		for (int i = 0; i < landmarks.nTargets(); i++) {
+			Weight & lb = landmarks.lowerBound(u, i);
+			if (lb < best)
+				best = lb;
+		}
+		return best;
+	}
+
+	void computeDistances() {
+		q.clear();
+		for (int u : touched) {
+			dist[u] = inf();
+			prev[u] = -1;
+		}
+		touched.clear();
+
+		int remaining = 0;
+		for (int i = 0; i < landmarks.nTargets(); i++) {
+			int t = landmarks.getTarget(i);
+			if (!is_target[t]) {
+				is_target[t] = true;
+				remaining++;
+			}
+		}
+		bool use_landmarks = landmarks.valid();
+		h[source] = heuristic(source, use_landmarks);
+		if (h[source] < inf() && remaining > 0) {
+			dist[source] = 0;
+			key[source] = h[source];
+			touched.push_back(source);
+			q.insert(source);
+		}
+		while (q.size()) {
+			int u = q.removeMin();
+			stats_nodes_settled++;
+			if (is_target[u] && --remaining == 0)
+				break;
+			for (int i = 0; i < g.nIncident(u, undirected); i++) {
+				int edgeID = g.incident(u, i, undirected).id;
+				if (!g.edgeEnabled(edgeID))
+					continue;
+				int v = g.incident(u, i, undirected).node;
+				Weight alt = dist[u] + g.getWeight(edgeID);
+				if (alt < dist[v]) {
+					if (dist[v] == inf()) {
+						h[v] = heuristic(v, use_landmarks);
+						if (h[v] >= inf())
+							continue;			//v cannot reach any target
+						touched.push_back(v);
+					}
+					dist[v] = alt;
+					key[v] = alt + h[v];
+					prev[v] = edgeID;
+					if (!q.inHeap(v))
+						q.insert(v);
+					else
+						q.decrease(v);
+				}
+			}
+		}
+		for (int i = 0; i < landmarks.nTargets(); i++) {
+			is_target[landmarks.getTarget(i)] = false;
+		}
+		searched_targets = landmarks.nTargets();
+	}
+public:
+	void update() {
+		if (last_modification > 0 && g.modifications == last_modification)
+			return;
+
+		if (last_addition == g.additions && last_edge_inc == g.edge_increases && last_edge_dec == g.edge_decreases
+				&& last_modification > 0 && dist.size() == g.nodes() && searched_targets == landmarks.nTargets()) {
+			//if none of the deletions were to edges in the current search tree, then nothing needs to be recomputed
+			if (last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
+				history_qhead = g.historyStart();
+				last_history_clear = g.historyclears;
+			}
+			bool need_recompute = false;
+			for (int i = history_qhead; i < g.historySize(); i++) {
+				int edgeid = g.getChange(i).id;
+				int u = g.getEdge(edgeid).from;
+				int v = g.getEdge(edgeid).to;
+				if (incomingEdge(u) == edgeid || incomingEdge(v) == edgeid) {
+					need_recompute = true;
+					break;
+				}
+			}
+			if (!need_recompute) {
+				last_modification = g.modifications;
+				last_deletion = g.deletions;
+				history_qhead = g.historySize();
+				g.updateHistoryConsumer(history_id, history_qhead);
+				stats_skip_deletes++;
+				return;
+			}
+		}
+
+		stats_full_updates++;
+		if (dist.size() != g.nodes()) {
+			dist.resize(g.nodes(), inf());
+			h.resize(g.nodes());
+			key.resize(g.nodes());
+			prev.resize(g.nodes(), -1);
+			is_target.resize(g.nodes(), false);
+		}
+
+		computeDistances();
+
+		for (int i = 0; i < landmarks.nTargets(); i++) {
+			int u = landmarks.getTarget(i);
+			if (reportPolarity <= 0 && dist[u] >= inf()) {
+				status.setReachable(u, false);
+				status.setMininumDistance(u, dist[u] < inf(), dist[u]);
+			} else if (reportPolarity >= 0 && dist[u] < inf()) {
+				status.setReachable(u, true);
+				status.setMininumDistance(u, dist[u] < inf(), dist[u]);
+			}
+		}
+		num_updates++;
+		last_modification = g.modifications;
+		last_deletion = g.deletions;
+		last_addition = g.additions;
+		last_edge_inc = g.edge_increases;
+		last_edge_dec = g.edge_decreases;
+		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
+		last_history_clear = g.historyclears;
+	}
+
+	bool connected_unsafe(int t) {
+		return t < dist.size() && dist[t] < inf();
+	}
+	bool connected_unchecked(int t) {
+		assert(last_modification == g.modifications);
+		return connected_unsafe(t);
+	}
+	bool connected(int t) {
+		if (last_modification != g.modifications)
+			update();
+		return connected_unsafe(t);
+	}
+	Weight & distance(int t) {
+		if (last_modification != g.modifications)
+			update();
+		if (connected_unsafe(t))
+			return dist[t];
+		return this->unreachable();
+	}
+	Weight &distance_unsafe(int t) {
+		if (connected_unsafe(t))
+			return dist[t];
+		else
+			return this->unreachable();
+	}
+	int incomingEdge(int t) {
+		if (t >= prev.size())
+			return -1;
+		assert(prev[t] >= -1);
+		return prev[t];
+	}
+	int previous(int t) {
+		if (incomingEdge(t) < 0)
+			return -1;
+		if (undirected && g.getEdge(incomingEdge(t)).from == t) {
+			return g.getEdge(incomingEdge(t)).to;
+		}
+		assert(g.getEdge(incomingEdge(t)).to == t);
+		return g.getEdge(incomingEdge(t)).from;
+	}
+};
+}
+;
+#endif /* ALTDIJKSTRA_H_ */
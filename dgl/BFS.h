@@ -42,6 +42,7 @@ public:
 	int history_qhead;
 
 	int last_history_clear;
+	int history_id;
 
 	int source;
 	int INF;
@@ -77,6 +78,7 @@ public:
 	BFSReachability(int s, DynamicGraph<Weight> & graph, Status & _status = Reach::nullStatus, int _reportPolarity = 0) :
 			g(graph), status(_status), last_modification(-1), last_addition(-1), last_deletion(-1), history_qhead(0), last_history_clear(
 					0), source(s), INF(0), reportPolarity(_reportPolarity) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		stats_full_updates = 0;
@@ -298,9 +300,9 @@ public:
 	}
 	bool update_additions() {
 		
-		if (g.historyclears != last_history_clear) {
+		if (g.historyclears != last_history_clear || !g.historyAvailable(history_qhead)) {
 			last_history_clear = g.historyclears;
-			history_qhead = 0;
+			history_qhead = g.historyStart();
 		}
 		
 		assert(INF > g.nodes());
@@ -355,6 +357,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		return true;
@@ -362,9 +365,9 @@ public:
 	
 	bool incrementalUpdate() {
 		
-		if (g.historyclears != last_history_clear) {
+		if (g.historyclears != last_history_clear || !g.historyAvailable(history_qhead)) {
 			last_history_clear = g.historyclears;
-			history_qhead = 0;
+			history_qhead = g.historyStart();
 		}
 		
 		assert(INF > g.nodes());
@@ -423,6 +426,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		return true;
@@ -458,9 +462,9 @@ public:
 		
 		setNodes(g.nodes());
 		
-		if (g.historyclears != last_history_clear) {
+		if (g.historyclears != last_history_clear || !g.historyAvailable(history_qhead)) {
 			last_history_clear = g.historyclears;
-			history_qhead = 0;
+			history_qhead = g.historyStart();
 		} else if (opt_inc_graph && last_modification > 0 && (g.historyclears <= (last_history_clear + 1))) {// && (g.historySize()-history_qhead < g.edges()*mod_percentage)){
 			if (opt_dec_graph == 2) {
 				if (incrementalUpdate())
@@ -547,6 +551,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		;
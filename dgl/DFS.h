@@ -42,6 +42,7 @@ public:
 	int history_qhead;
 
 	int last_history_clear;
+	int history_id;
 
 	int source;
 	int INF;
@@ -77,9 +78,11 @@ public:
 	DFSReachability(int s, DynamicGraph<Weight> & graph, Status & _status= Reach::nullStatus, int _reportPolarity = 0) :
 			g(graph), status(_status), last_modification(-1), last_addition(-1), last_deletion(-1), history_qhead(0), last_history_clear(
 					0), source(s), INF(0), reportPolarity(_reportPolarity) {
+		history_id = g.addHistoryConsumer();
 	}
 	DFSReachability(DynamicGraph<Weight> & graph,Status & _status= Reach::nullStatus, int _reportPolarity = 0):			g(graph), status(_status), last_modification(-1), last_addition(-1), last_deletion(-1), history_qhead(0), last_history_clear(
 			0), source(0), INF(0), reportPolarity(_reportPolarity) {
+		history_id = g.addHistoryConsumer();
 	}
 	//Connectivity(const Connectivity& d):g(d.g), last_modification(-1),last_addition(-1),last_deletion(-1),history_qhead(0),last_history_clear(0),source(d.source),INF(0),mod_percentage(0.2),stats_full_updates(0),stats_fast_updates(0),stats_skip_deletes(0),stats_skipped_updates(0),stats_full_update_time(0),stats_fast_update_time(0){marked=false;};
 	
@@ -272,9 +275,9 @@ public:
 	}
 	bool update_additions() {
 		
-		if (g.historyclears != last_history_clear) {
+		if (g.historyclears != last_history_clear || !g.historyAvailable(history_qhead)) {
 			last_history_clear = g.historyclears;
-			history_qhead = 0;
+			history_qhead = g.historyStart();
 		}
 		
 		assert(INF > g.nodes());
@@ -326,6 +329,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		return true;
@@ -333,9 +337,9 @@ public:
 	
 	bool incrementalUpdate() {
 		
-		if (g.historyclears != last_history_clear) {
+		if (g.historyclears != last_history_clear || !g.historyAvailable(history_qhead)) {
 			last_history_clear = g.historyclears;
-			history_qhead = 0;
+			history_qhead = g.historyStart();
 		}
 		
 		assert(INF > g.nodes());
@@ -389,6 +393,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		return true;
@@ -421,9 +426,9 @@ public:
 		
 		setNodes(g.nodes());
 		
-		if (g.historyclears != last_history_clear) {
+		if (g.historyclears != last_history_clear || !g.historyAvailable(history_qhead)) {
 			last_history_clear = g.historyclears;
-			history_qhead = 0;
+			history_qhead = g.historyStart();
 		} else if (opt_inc_graph && last_modification > 0 && (g.historyclears <= (last_history_clear + 1))) {// && (g.history.size()-history_qhead < g.edges()*mod_percentage)){
 			if (opt_dec_graph == 2) {
 				if (incrementalUpdate())
@@ -519,6 +524,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		;
@@ -130,10 +130,13 @@ public:
 							directed_cycle.clear();
 							directed_cycle.push_back(id);
 							assert(path.size() == q.size() - 1);
-							for (int j = 1; j < q.size(); j++) {
-								if (seen[j]) {
-									directed_cycle.push_back(path[j - 1]);
-								}
+							//v is on the dfs stack; the cycle is the back edge u->v, followed by the tree path from v to u.
+							//(path[j-1] is the edge leading into q[j].)
+							int j = q.size() - 1;
+							while (q[j] != v) {
+								assert(j > 0);
+								directed_cycle.push_back(path[j - 1]);
+								j--;
 							}
 							if(undirected && !has_undirected_cycle){
 								//a directed cycle is also an undirected cycle.
@@ -197,10 +200,13 @@ public:
 							//a directed cycle is also an undirected cycle.
 							has_undirected_cycle=true;
 							assert(path.size() == q.size() - 1);
-							for (int j = 1; j < q.size(); j++) {
-								if (seen[j]) {
-									undirected_cycle.push_back(path[j - 1]);
-								}
+							//an undirected dfs has no cross edges, so v is an ancestor of u on the dfs stack.
+							undirected_cycle.push_back(id);
+							int j = q.size() - 1;
+							while (q[j] != v) {
+								assert(j > 0);
+								undirected_cycle.push_back(path[j - 1]);
+								j--;
 							}
 							return;
 						}
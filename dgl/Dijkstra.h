@@ -24,11 +24,13 @@
 
 #include <vector>
 #include "alg/Heap.h"
+#include "alg/RadixHeap.h"
 #include "DynamicGraph.h"
 #include "Reach.h"
 #include "Distance.h"
 #include "core/Config.h"
 #include <limits>
+#include <type_traits>
 namespace dgl {
 
 template<typename Weight = long, class Status = typename Distance<Weight>::NullStatus, bool undirected = false>
@@ -49,6 +51,7 @@ public:
 	int history_qhead=0;
 
 	int last_history_clear=0;
+	int history_id=-1;
 
 	int source;
 	//Weight inf();
@@ -65,6 +68,7 @@ public:
 		;
 	};
 	Heap<DistCmp> q;
+	RadixHeap rq;
 
 public:
 	
@@ -80,6 +84,7 @@ public:
 	double stats_fast_update_time = 0;
 	Dijkstra(int s, DynamicGraph<Weight> & graph, Status & status, int reportPolarity = 0) :
 			g(graph), status(status), reportPolarity(reportPolarity), source(s),  q(DistCmp(dist)) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		
@@ -87,6 +92,7 @@ public:
 	
 	Dijkstra(int s, DynamicGraph<Weight>  & graph,  int reportPolarity = 0) :
 			g(graph), status(Distance<Weight>::nullStatus), reportPolarity(reportPolarity),  source(s), q(DistCmp(dist)) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		//inf()=std::numeric_limits<Weight>::max()/2;
@@ -111,6 +117,75 @@ public:
 	int numUpdates() const {
 		return num_updates;
 	}
+private:
+	void resetDistances() {
+		for (int i = 0; i < g.nodes(); i++) {
+			dist[i] = inf();
+			prev[i] = -1;
+		}
+		dist[source] = 0;
+	}
+	
+	void computeDistances() {
+		q.clear();
+		resetDistances();
+		q.insert(source);
+		while (q.size()) {
+			int u = q.peekMin();
+			if (dist[u] == inf())
+				break;
+			q.removeMin();
+			for (int i = 0; i < g.nIncident(u, undirected); i++) {
+				if (!g.edgeEnabled(g.incident(u, i, undirected).id))
+					continue;
+				int edgeID = g.incident(u, i, undirected).id;
+				int v = g.incident(u, i, undirected).node;
+				Weight alt = dist[u] + g.getWeight(edgeID);
+				if (alt < dist[v]) {
+					dist[v] = alt;
+					prev[v] = edgeID;
+					if (!q.inHeap(v))
+						q.insert(v);
+					else
+						q.decrease(v);
+				}
+			}
+		}
+	}
+	
+	bool computeDistancesRadix(std::false_type) {
+		return false;
+	}
+	
+	//Returns false (leaving the distances to be recomputed) if a negative edge weight is encountered.
+	bool computeDistancesRadix(std::true_type) {
+		rq.clear();
+		resetDistances();
+		rq.push(0, source);
+		while (!rq.empty()) {
+			uint64_t key;
+			int u = rq.pop(key);
+			if (key != (uint64_t) dist[u])
+				continue; //stale entry; u was already settled with a smaller distance
+			for (int i = 0; i < g.nIncident(u, undirected); i++) {
+				if (!g.edgeEnabled(g.incident(u, i, undirected).id))
+					continue;
+				int edgeID = g.incident(u, i, undirected).id;
+				int v = g.incident(u, i, undirected).node;
+				Weight w = g.getWeight(edgeID);
+				if (w < 0)
+					return false;
+				Weight alt = dist[u] + w;
+				if (alt < dist[v]) {
+					dist[v] = alt;
+					prev[v] = edgeID;
+					rq.push((uint64_t) alt, v);
+				}
+			}
+		}
+		return true;
+	}
+public:
 	void update() {
 		static int iteration = 0;
 		int local_it = ++iteration;
@@ -120,8 +195,8 @@ public:
 		
 		if (last_addition == g.additions && last_edge_inc==g.edge_increases  && last_edge_dec==g.edge_decreases  && last_modification > 0) {
 			//if none of the deletions were to edges that were the previous edge of some shortest path, then we don't need to do anything
-			if (last_history_clear != g.historyclears) {
-				history_qhead = 0;
+			if (last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
+				history_qhead = g.historyStart();
 				last_history_clear = g.historyclears;
 			}
 			bool need_recompute = false;
@@ -153,6 +228,7 @@ public:
 				last_edge_inc = g.edge_increases;
 				last_edge_dec = g.edge_decreases;
 				history_qhead = g.historySize();
+				g.updateHistoryConsumer(history_id, history_qhead);
 				last_history_clear = g.historyclears;
 				
 				assert(dbg_uptodate());
@@ -173,40 +249,9 @@ public:
 			prev.resize(g.nodes());
 		}
 		
-		//old_dist.resize(g.nodes());
-		q.clear();
-		for (int i = 0; i < g.nodes(); i++) {
-			//old_dist[i]=last_modification > 0 ? dist[i]:inf();//this won't work properly if we added nodes...
-			dist[i] =  inf();
-			prev[i] = -1;
-		}
-		
-		dist[source] = 0;
-		q.insert(source);
-		while (q.size()) {
-			int u = q.peekMin();
-			if (dist[u] == inf())
-				break;
-			/*if(old_dist[u]>=inf()){
-			 changed.push_back(u);
-			 }*/
-			q.removeMin();
-			for (int i = 0; i < g.nIncident(u, undirected); i++) {
-				if (!g.edgeEnabled(g.incident(u, i, undirected).id))
-					continue;
-				int edgeID = g.incident(u, i, undirected).id;
-				int v = g.incident(u, i, undirected).node;
-				Weight alt = dist[u] +  g.getWeight(edgeID);
-				if (alt < dist[v]) {
-					dist[v] = alt;
-					prev[v] = edgeID;
-					if (!q.inHeap(v))
-						q.insert(v);
-					else
-						q.decrease(v);
-				}
-			}
-		}
+		//Integer weights (e.g. from bitvector edges) use a monotone radix heap; other weights fall back to the binary heap.
+		if (!computeDistancesRadix(std::is_integral<Weight>()))
+			computeDistances();
 		
 		assert(dbg_uptodate());
 		for (int u = 0; u < g.nodes(); u++) {
@@ -225,6 +270,7 @@ public:
 		last_edge_inc = g.edge_increases;
 		last_edge_dec = g.edge_decreases;
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 	}
@@ -334,6 +380,7 @@ public:
 	int history_qhead=0;
 
 	int last_history_clear=0;
+	int history_id=-1;
 
 	int source;
 
@@ -365,6 +412,7 @@ public:
 	double stats_fast_update_time = 0;
 	UnweightedDijkstra(int s, DynamicGraph<Weight>  & graph, Status & status, int reportPolarity = 0) :
 			g(graph), status(status), reportPolarity(reportPolarity),source(s),  q(DistCmp(dist)) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		
@@ -372,6 +420,7 @@ public:
 	
 	UnweightedDijkstra(int s, DynamicGraph<Weight>  & graph, int reportPolarity = 0) :
 			g(graph), status(Distance<int>::nullStatus), reportPolarity(reportPolarity), source(s),  q(DistCmp(dist)) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		
@@ -403,8 +452,8 @@ public:
 		
 		if (last_addition == g.additions && last_modification > 0) {
 			//if none of the deletions were to edges that were the previous edge of some shortest path, then we don't need to do anything
-			if (last_history_clear != g.historyclears) {
-				history_qhead = 0;
+			if (last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
+				history_qhead = g.historyStart();
 				last_history_clear = g.historyclears;
 			}
 			bool need_recompute = false;
@@ -435,6 +484,7 @@ public:
 				last_addition = g.additions;
 				
 				history_qhead = g.historySize();
+				g.updateHistoryConsumer(history_id, history_qhead);
 				last_history_clear = g.historyclears;
 				
 				assert(dbg_uptodate());
@@ -521,6 +571,7 @@ public:
 		last_addition = g.additions;
 
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 	}
@@ -0,0 +1,287 @@
+/****************************************************************************************[DreyfusWagner.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef DREYFUS_WAGNER_H_
+#define DREYFUS_WAGNER_H_
+
+#include <vector>
+#include "alg/Heap.h"
+#include "DynamicGraph.h"
+#include "SteinerTree.h"
+#include "SteinerApprox.h"
+#include "Distance.h"
+
+namespace dgl {
+/**
+ * Exact minimum Steiner trees (over the undirected view of the graph), by the Dreyfus-Wagner/
+ * Erickson-Monma-Veinott dynamic program over subsets of the enabled terminals.
+ * Takes O(3^k n + 2^k m log n) time and O(2^k n) space for k enabled terminals, so when more than
+ * max_terminals terminals are enabled, this falls back on SteinerApprox instead.
+ */
+template<class TerminalSet, class Status, typename Weight = int>
+class DreyfusWagner: public SteinerTree<Weight> {
+public:
+	DynamicGraph<Weight> & g;
+	TerminalSet & terminals;
+	Status & status;
+	const int reportPolarity;
+	const int max_terminals;
+
+	int last_modification = -1;
+	int last_deletion = -1;
+	int last_addition = -1;
+	int history_qhead = 0;
+	int last_history_clear = 0;
+
+	Weight min_weight = 0;
+	bool is_disconnected = false;
+	bool using_approx = false;
+	std::vector<int> tree_edges;
+	//The enabled terminals as of the last update
+	std::vector<int> enabled_terminals;
+
+	SteinerApprox<TerminalSet, Status, Weight> approx;
+
+	long stats_full_updates = 0;
+	long stats_skipped_updates = 0;
+	long stats_approx_updates = 0;
+
+private:
+	int n = 0;
+	//dp[S*n+v] is the weight of the lightest tree connecting v to the terminals in S (the last terminal, the root, is never in S).
+	std::vector<Weight> dp;
+	//How each dp entry was reached: -1 for a base case, an edge ID (>=0) if extended along that edge from its other endpoint,
+	//or -(T+2) if formed by merging the trees for subsets T and S\T at v.
+	std::vector<int> back;
+	std::vector<Weight> dist;
+	std::vector<char> in_tree;
+	struct DistCmp {
+		std::vector<Weight> & _dist;
+		bool operator()(int a, int b) const {
+			return _dist[a] < _dist[b];
+		}
+		DistCmp(std::vector<Weight> & d) :
+				_dist(d) {
+		}
+		;
+	};
+	Heap<DistCmp> q;
+
+	Weight & inf() {
+		return Distance<Weight>::INF;
+	}
+
+	//Dijkstra over the undirected graph, seeded with every node's current value in row S of the table.
+	void relax(int S) {
+		Weight * row = &dp[(size_t) S * n];
+		int * brow = &back[(size_t) S * n];
+		q.clear();
+		for (int v = 0; v < n; v++) {
+			dist[v] = row[v];
+			if (dist[v] < inf())
+				q.insert(v);
+		}
+		while (q.size()) {
+			int u = q.removeMin();
+			for (int i = 0; i < g.nIncident(u, true); i++) {
+				int edgeID = g.incident(u, i, true).id;
+				if (!g.edgeEnabled(edgeID))
+					continue;
+				int v = g.incident(u, i, true).node;
+				Weight alt = dist[u] + g.getWeight(edgeID);
+				if (alt < dist[v]) {
+					dist[v] = alt;
+					brow[v] = edgeID;
+					if (!q.inHeap(v))
+						q.insert(v);
+					else
+						q.decrease(v);
+				}
+			}
+		}
+		for (int v = 0; v < n; v++)
+			row[v] = dist[v];
+	}
+
+	void collectTree(int S, int v) {
+		while (true) {
+			int b = back[(size_t) S * n + v];
+			if (b == -1) {
+				return;
+			} else if (b >= 0) {
+				if (!in_tree[b]) {
+					in_tree[b] = true;
+					tree_edges.push_back(b);
+					min_weight += g.getWeight(b);
+				}
+				v = g.getEdge(b).from == v ? g.getEdge(b).to : g.getEdge(b).from;
+			} else {
+				int T = -(b + 2);
+				collectTree(T, v);
+				S ^= T;
+			}
+		}
+	}
+
+	bool terminalsChanged() {
+		int k = 0;
+		for (int i = 0; i < terminals.nodes(); i++) {
+			if (terminals.nodeEnabled(i)) {
+				if (k >= enabled_terminals.size() || enabled_terminals[k] != i)
+					return true;
+				k++;
+			}
+		}
+		return k != enabled_terminals.size();
+	}
+
+	void computeSteinerTree() {
+		int k = enabled_terminals.size();
+		n = g.nodes();
+		int root = enabled_terminals[k - 1];
+		int full = (1 << (k - 1)) - 1;
+		dp.assign((size_t) (full + 1) * n, inf());
+		back.assign((size_t) (full + 1) * n, -1);
+		dist.resize(n);
+		for (int i = 0; i < k - 1; i++) {
+			dp[(size_t) (1 << i) * n + enabled_terminals[i]] = 0;
+		}
+
+		for (int S = 1; S <= full; S++) {
+			Weight * row = &dp[(size_t) S * n];
+			int * brow = &back[(size_t) S * n];
+			if (S & (S - 1)) {
+				//Merge the trees for each split of S into two non-empty parts. Only consider the splits T that contain
+				//S's lowest terminal, since (T, S\T) and (S\T, T) are the same split.
+				int low = S & -S;
+				for (int T = (S - 1) & S; T > 0; T = (T - 1) & S) {
+					if (!(T & low))
+						continue;
+					const Weight * a = &dp[(size_t) T * n];
+					const Weight * b = &dp[(size_t) (S ^ T) * n];
+					int code = -(T + 2);
+					//No dependencies between iterations, so this loop vectorizes for arithmetic weights.
+					for (int v = 0; v < n; v++) {
+						Weight w = a[v] + b[v];
+						bool better = w < row[v];
+						row[v] = better ? w : row[v];
+						brow[v] = better ? code : brow[v];
+					}
+				}
+			}
+			relax(S);
+		}
+		if (k == 1 || dp[(size_t) full * n + root] < inf()) {
+			is_disconnected = false;
+			in_tree.clear();
+			in_tree.resize(g.edges(), false);
+			tree_edges.clear();
+			min_weight = 0;
+			if (k > 1)
+				collectTree(full, root);
+			assert(min_weight <= dp[(size_t) full * n + root]);
+		} else {
+			is_disconnected = true;
+			tree_edges.clear();
+			min_weight = 0;
+		}
+	}
+
+public:
+	DreyfusWagner(DynamicGraph<Weight> & graph, TerminalSet & terminals, Status & _status, int _reportPolarity = 0,
+			int max_terminals = 8) :
+			g(graph), terminals(terminals), status(_status), reportPolarity(_reportPolarity), max_terminals(
+					max_terminals), approx(graph, terminals, _status, _reportPolarity), q(DistCmp(dist)) {
+	}
+
+	void update() {
+		if (last_modification > 0 && g.modifications == last_modification && !terminalsChanged()) {
+			stats_skipped_updates++;
+			return;
+		}
+
+		enabled_terminals.clear();
+		for (int i = 0; i < terminals.nodes(); i++) {
+			if (terminals.nodeEnabled(i))
+				enabled_terminals.push_back(i);
+		}
+
+		last_modification = g.modifications;
+		last_deletion = g.deletions;
+		last_addition = g.additions;
+		history_qhead = g.historySize();
+		last_history_clear = g.historyclears;
+
+		if (enabled_terminals.size() > max_terminals) {
+			stats_approx_updates++;
+			using_approx = true;
+			approx.update();
+			return;
+		}
+		using_approx = false;
+		stats_full_updates++;
+
+		if (enabled_terminals.size() > 0) {
+			computeSteinerTree();
+		} else {
+			is_disconnected = false;
+			min_weight = 0;
+			tree_edges.clear();
+		}
+
+		if (is_disconnected) {
+			status.setMinimumSteinerTree(inf());
+		} else {
+			status.setMinimumSteinerTree(min_weight);
+		}
+	}
+
+	Weight &weight() {
+		update();
+		if (using_approx)
+			return approx.weight();
+		if (is_disconnected)
+			return inf();
+		return min_weight;
+	}
+
+	bool disconnected() {
+		update();
+		if (using_approx)
+			return approx.disconnected();
+		return is_disconnected;
+	}
+
+	void getSteinerTree(std::vector<int> & edges) {
+		if (using_approx)
+			approx.getSteinerTree(edges);
+		else
+			edges = tree_edges;
+	}
+
+	void printStats() {
+		printf("\tExact Steiner updates: %ld (approximate: %ld, skipped: %ld)\n", stats_full_updates,
+				stats_approx_updates, stats_skipped_updates);
+	}
+};
+}
+;
+#endif
@@ -28,6 +28,8 @@
 
 #include <sstream>
 #include <cstdio>
+#include <climits>
+#include <memory>
 
 namespace dgl {
 
@@ -61,10 +63,21 @@ class DynamicGraph {
 	int num_edges=0;
 	int next_id=0;
 	bool is_changed=false;
+	//Registered history consumers (see addHistoryConsumer), and the position in the history that each has read up to
+	//(or -1, if it has not yet read the history).
 	std::vector<DynamicGraphAlgorithm*> dynamic_algs;
-	std::vector<int> dynamic_history_pos;
-
+	std::vector<long> dynamic_history_pos;
+	//An upper bound on the positions of all of the consumers; changes at or after this position have not been read by anyone.
+	long history_seen=0;
+	//For each edge, the position of the most recent change to that edge in the history
+	std::vector<long> last_change;
+	//The history is a ring buffer, holding the changes at positions [history_offset,history_end)
 	long history_offset=0;
+	long history_end=0;
+	//Batches of changes (see beginBatch)
+	bool in_batch=false;
+	int batch_changes=0;
+	int batch_mod=-1;
 
 public:
 	bool disable_history_clears=false;
@@ -79,13 +92,16 @@ public:
 	int edge_decreases = 0;
 	long historyclears=0;
 	long skipped_historyclears=0;
+	//Number of times that the history was trimmed while some consumer still had unread changes in it
+	long history_overflows=0;
+	//Number of enable/disable pairs that cancelled out before any consumer read them
+	long history_compactions=0;
+	//Cancel an enable/disable pair only if doing so moves at most this many later changes
+	int max_compaction_distance=64;
 	struct Edge {
 		int node;
 		int id;
 	};
-	std::vector<std::vector<Edge> > adjacency_list;
-	std::vector<std::vector<Edge> > inverted_adjacency_list;
-	std::vector<std::vector<Edge> > adjacency_undirected_list;
 public:
 	struct FullEdge {
 		int from;
@@ -100,11 +116,37 @@ public:
 		} //,weight(weight){}
 	};
 
+	/**
+	 * The nodes and edges of a graph, without any of the state that changes as edges are enabled and disabled.
+	 * Several DynamicGraphs over the same nodes and edges (with their own enabled edges, weights, and history)
+	 * can share a single Topology (see shareTopology()).
+	 */
+	struct Topology {
+		std::vector<std::vector<Edge> > adjacency_list;
+		std::vector<std::vector<Edge> > inverted_adjacency_list;
+		std::vector<std::vector<Edge> > adjacency_undirected_list;
+		std::vector<FullEdge> all_edges;
+
+		int nodes() const {
+			return adjacency_list.size();
+		}
+		bool hasEdge(int id) const {
+			return id < all_edges.size() && all_edges[id].id == id;
+		}
+		//Approximate number of bytes allocated for the topology
+		size_t memoryUsage() const {
+			size_t bytes = sizeof(Topology) + all_edges.capacity() * sizeof(FullEdge);
+			for (auto * lists : { &adjacency_list, &inverted_adjacency_list, &adjacency_undirected_list }) {
+				bytes += lists->capacity() * sizeof(std::vector<Edge>);
+				for (auto & list : *lists)
+					bytes += list.capacity() * sizeof(Edge);
+			}
+			return bytes;
+		}
+	};
 private:
-#ifndef NDEBUG
-public:
-#endif
-	std::vector<FullEdge> all_edges;
+	std::shared_ptr<Topology> topology_ptr = std::make_shared<Topology>();
+	Topology * topology = topology_ptr.get();
 public:
 	struct EdgeChange {
 		bool addition;
@@ -116,7 +158,70 @@ public:
 		int prev_mod;
 	};
 private:
+	//Ring buffer of changes; its size is always a power of two.
 	std::vector<EdgeChange> history;
+
+	inline EdgeChange & historyAt(long historyPos) {
+		return history[historyPos & (history.size() - 1)];
+	}
+	inline long historyLength() const {
+		return history_end - history_offset;
+	}
+	void pushChange(const EdgeChange & change) {
+		if (historyLength() >= (long) history.size()) {
+			std::vector<EdgeChange> grown(std::max((size_t) 64, history.size() * 2));
+			for (long i = history_offset; i < history_end; i++)
+				grown[i & (grown.size() - 1)] = historyAt(i);
+			history.swap(grown);
+		}
+		historyAt(history_end) = change;
+		last_change[change.id] = history_end;
+		history_end++;
+	}
+	EdgeChange & lastChange() {
+		assert(historyLength() > 0);
+		return historyAt(history_end - 1);
+	}
+	const EdgeChange & lastChange() const {
+		assert(historyLength() > 0);
+		return history[(history_end - 1) & (history.size() - 1)];
+	}
+	void popChange() {
+		assert(historyLength() > 0);
+		history_end--;
+	}
+
+	/**
+	 * If the most recent change to this edge was the opposite of this one (an enable, for a disable, or vice versa),
+	 * and no consumer has read it yet, then the two changes cancel; remove the earlier one from the history
+	 * (moving the changes after it back by one) and return true.
+	 */
+	bool cancelChange(int id, bool addition) {
+		long p = last_change[id];
+		if (p < history_offset || p >= history_end || p < history_seen || history_end - p > max_compaction_distance)
+			return false;
+		EdgeChange & prev = historyAt(p);
+		if (prev.id != id || (addition ? !prev.deletion : !prev.addition))
+			return false;
+		for (long i = p + 1; i < history_end; i++) {
+			historyAt(i - 1) = historyAt(i);
+			last_change[historyAt(i - 1).id] = i - 1;
+		}
+		history_end--;
+		last_change[id] = -1;
+		history_compactions++;
+		return true;
+	}
+
+	//Advance the modification count for a new change (only once per batch, if a batch is open)
+	inline void nextModification() {
+		if (!in_batch || batch_changes++ == 0)
+			modifications++;
+	}
+	//Changes in a batch share a modification count, so they can only be undone by undoing the whole batch
+	inline bool canUndo() const {
+		return historyLength() > 0 && lastChange().mod == modifications && modifications != batch_mod;
+	}
 public:
 	//Logfile information if recording is enabled.
 	FILE * outfile=nullptr;
@@ -138,8 +243,8 @@ public:
 	}
 	//SLOW!
 	bool hasEdge(int from, int to) const {
-		for (int i = 0; i < adjacency_list[from].size(); i++) {
-			if (adjacency_list[from][i].node == to && edgeEnabled(adjacency_list[from][i].id)) {
+		for (int i = 0; i < topology->adjacency_list[from].size(); i++) {
+			if (topology->adjacency_list[from][i].node == to && edgeEnabled(topology->adjacency_list[from][i].id)) {
 				return true;
 			}
 		}
@@ -147,16 +252,16 @@ public:
 	}
 	//SLOW! Returns -1 if there is no edge
 	int getEdge(int from, int to) const {
-		for (int i = 0; i < adjacency_list[from].size(); i++) {
-			if (adjacency_list[from][i].node == to && edgeEnabled(adjacency_list[from][i].id)) {
-				return adjacency_list[from][i].id;
+		for (int i = 0; i < topology->adjacency_list[from].size(); i++) {
+			if (topology->adjacency_list[from][i].node == to && edgeEnabled(topology->adjacency_list[from][i].id)) {
+				return topology->adjacency_list[from][i].id;
 			}
 		}
 		return -1;
 	}
 	bool hasEdgeUndirected(int from, int to) const {
-		for (int i = 0; i < adjacency_undirected_list[from].size(); i++) {
-			if (adjacency_undirected_list[from][i].node == to && edgeEnabled(adjacency_undirected_list[from][i].id)) {
+		for (int i = 0; i < topology->adjacency_undirected_list[from].size(); i++) {
+			if (topology->adjacency_undirected_list[from][i].node == to && edgeEnabled(topology->adjacency_undirected_list[from][i].id)) {
 				return true;
 			}
 		}
@@ -165,9 +270,14 @@ public:
 	
 	int addNode() {
 		
-		adjacency_list.push_back( { }); //adj list
-		adjacency_undirected_list.push_back( { });
-		inverted_adjacency_list.push_back( { });
+		if (num_nodes == topology->nodes()) {
+			topology->adjacency_list.push_back( { }); //adj list
+			topology->adjacency_undirected_list.push_back( { });
+			topology->inverted_adjacency_list.push_back( { });
+		} else {
+			//this node was already added to a shared topology by another graph
+			assert(num_nodes < topology->nodes());
+		}
 		modifications++;
 		additions = modifications;
 		deletions = modifications;
@@ -197,7 +307,7 @@ public:
 		return edge_status[edgeID];
 	}
 	bool isEdge(int edgeID) const {
-		return edgeID < all_edges.size() && all_edges[edgeID].id == edgeID;
+		return edgeID < edge_status.size() && topology->hasEdge(edgeID);
 	}
 	bool hasEdge(int edgeID) const {
 		return isEdge(edgeID);
@@ -217,9 +327,19 @@ public:
 		}
 		
 		num_edges = next_id;
-		adjacency_list[from].push_back( { to, id });
-		adjacency_undirected_list[from].push_back( { to, id });
-		adjacency_undirected_list[to].push_back( { from, id });
+		if (!topology->hasEdge(id)) {
+			topology->adjacency_list[from].push_back( { to, id });
+			topology->adjacency_undirected_list[from].push_back( { to, id });
+			topology->adjacency_undirected_list[to].push_back( { from, id });
+			topology->inverted_adjacency_list[to].push_back( { from, id });
+			if (topology->all_edges.size() <= id)
+				topology->all_edges.resize(id + 1);
+			topology->all_edges[id]= {from,to,id}; //,weight};
+		} else {
+			//this edge was already added to a shared topology by another graph
+			assert(topology->all_edges[id].from == from);
+			assert(topology->all_edges[id].to == to);
+		}
 		if (edge_status.size() <= id)
 			edge_status.resize(id + 1);
 
@@ -227,13 +347,11 @@ public:
 			edge_status_const.resize(id+1,false);
 		}
 
-		inverted_adjacency_list[to].push_back( { from, id });
-		if (all_edges.size() <= id)
-			all_edges.resize(id + 1);
-		all_edges[id]= {from,to,id}; //,weight};
 		if(weights.size()<=id)
 			weights.resize(id+1,0);
 		weights[id]=weight;
+		if(last_change.size()<=id)
+			last_change.resize(id+1,-1);
 
 		modifications++;
 		additions = modifications;
@@ -255,7 +373,7 @@ public:
 		return id;
 	}
 	int nEdgeIDs() {
-		assert(num_edges == all_edges.size());
+		assert(num_edges == topology->all_edges.size());
 		return num_edges;		//all_edges.size();
 	}
 	inline int nodes() const {
@@ -269,9 +387,9 @@ public:
 		assert(node >= 0);
 		assert(node < nodes());
 		if (undirected) {
-			return adjacency_undirected_list[node].size();
+			return topology->adjacency_undirected_list[node].size();
 		} else {
-			return adjacency_list[node].size();
+			return topology->adjacency_list[node].size();
 		}
 	}
 	
@@ -296,9 +414,9 @@ public:
 		assert(node >= 0);
 		assert(node < nodes());
 		if (undirected) {
-			return adjacency_undirected_list[node].size();
+			return topology->adjacency_undirected_list[node].size();
 		} else {
-			return inverted_adjacency_list[node].size();
+			return topology->inverted_adjacency_list[node].size();
 		}
 	}
 	
@@ -307,9 +425,9 @@ public:
 		assert(node < nodes());
 		assert(i < nIncident(node, undirected));
 		if (undirected) {
-			return adjacency_undirected_list[node][i];
+			return topology->adjacency_undirected_list[node][i];
 		} else {
-			return adjacency_list[node][i];
+			return topology->adjacency_list[node][i];
 		}
 	}
 	inline Edge & incoming(int node, int i, bool undirected = false) {
@@ -317,13 +435,13 @@ public:
 		assert(node < nodes());
 		assert(i < nIncoming(node, undirected));
 		if (undirected) {
-			return adjacency_undirected_list[node][i];
+			return topology->adjacency_undirected_list[node][i];
 		} else {
-			return inverted_adjacency_list[node][i];
+			return topology->inverted_adjacency_list[node][i];
 		}
 	}
 	std::vector<FullEdge> & getEdges(){
-		return all_edges;
+		return topology->all_edges;
 	}
 
 	std::vector<Weight> & getWeights(){
@@ -338,7 +456,7 @@ public:
 	 //return all_edges[edgeID].weight;
 	 }
 	FullEdge & getEdge(int id)  {
-		return all_edges[id];
+		return topology->all_edges[id];
 	}
 	void setEdgeEnabled(int id, bool enable){
 		if(enable){
@@ -349,10 +467,10 @@ public:
 	}
 
 	void enableEdge(int id) {
-		enableEdge(all_edges[id].from, all_edges[id].to, id);
+		enableEdge(topology->all_edges[id].from, topology->all_edges[id].to, id);
 	}
 	void disableEdge(int id) {
-		disableEdge(all_edges[id].from, all_edges[id].to, id);
+		disableEdge(topology->all_edges[id].from, topology->all_edges[id].to, id);
 	}
 	void enableEdge(int from, int to, int id) {
 		assert(id >= 0);
@@ -362,9 +480,10 @@ public:
 			edge_status[id] = true;
 			//edge_status.setStatus(id,true);
 			
-			modifications++;
+			nextModification();
 			additions = modifications;
-			history.push_back( { true,false,false,false, id, modifications, additions });
+			if (!cancelChange(id, true))
+				pushChange( { true,false,false,false, id, modifications, additions });
 
 			if (outfile) {
 				
@@ -379,10 +498,10 @@ public:
 		assert(id >= 0);
 		assert(id < edge_status.size());
 		assert(isEdge(id));
-		if (!history.size())
+		if (!canUndo())
 			return false;
 		
-		if (history.back().addition && history.back().id == id && history.back().mod == modifications) {
+		if (lastChange().addition && lastChange().id == id) {
 			//edge_status.setStatus(id,false);
 			edge_status[id] = false;
 
@@ -395,8 +514,8 @@ public:
 			}
 
 			modifications--;
-			additions = history.back().prev_mod;
-			history.pop_back();
+			additions = lastChange().prev_mod;
+			popChange();
 			return true;
 		}
 		return false;
@@ -415,9 +534,10 @@ public:
 				fflush(outfile);
 			}
 			
-			modifications++;
+			nextModification();
 			
-			history.push_back( { false,true,false,false, id, modifications, deletions });
+			if (!cancelChange(id, false))
+				pushChange( { false,true,false,false, id, modifications, deletions });
 			deletions = modifications;
 		}
 	}
@@ -426,10 +546,10 @@ public:
 		assert(id >= 0);
 		assert(id < edge_status.size());
 		assert(isEdge(id));
-		if (!history.size())
+		if (!canUndo())
 			return false;
 		
-		if (!history.back().addition && history.back().id == id && history.back().mod == modifications) {
+		if (!lastChange().addition && lastChange().id == id) {
 			//edge_status.setStatus(id,true);
 			edge_status[id] = true;
 
@@ -440,8 +560,8 @@ public:
 			}
 
 			modifications--;
-			deletions = history.back().prev_mod;
-			history.pop_back();
+			deletions = lastChange().prev_mod;
+			popChange();
 			return true;
 		}
 		return false;
@@ -457,13 +577,13 @@ public:
 				return;
 			}
 
-			modifications++;
+			nextModification();
 			if(w>getWeight(id)){
-				history.push_back( {false,false, true,false, id, modifications, additions });
+				pushChange( {false,false, true,false, id, modifications, additions });
 				edge_increases = modifications;
 			}else{
 				assert(w<getWeight(id));
-				history.push_back( {false,false, false, true, id, modifications, additions });
+				pushChange( {false,false, false, true, id, modifications, additions });
 				edge_decreases = modifications;
 			}
 			weights[id]=w;
@@ -487,10 +607,10 @@ public:
 			printf("n%d\n", i);
 		}
 		
-		for (int i = 0; i < adjacency_list.size(); i++) {
-			for (int j = 0; j < adjacency_list[i].size(); j++) {
-				int id = adjacency_list[i][j].id;
-				int u = adjacency_list[i][j].node;
+		for (int i = 0; i < topology->adjacency_list.size(); i++) {
+			for (int j = 0; j < topology->adjacency_list[i].size(); j++) {
+				int id = topology->adjacency_list[i][j].id;
+				int u = topology->adjacency_list[i][j].node;
 				const char * s = "black";
 				if (edgeEnabled(id))
 					s = "red";
@@ -510,11 +630,28 @@ public:
 
 	}
 	
+	/**
+	 * Between beginBatch() and endBatch(), all of the edges that are enabled or disabled (or have their weights changed)
+	 * count as a single modification of the graph, so the algorithms see the whole batch as one new version of the graph.
+	 */
+	void beginBatch() {
+		assert(!in_batch);
+		in_batch = true;
+		batch_changes = 0;
+	}
+
+	void endBatch() {
+		assert(in_batch);
+		in_batch = false;
+		if (batch_changes > 1)
+			batch_mod = modifications;
+	}
+
 	bool rewindHistory(int steps) {
 		
 		int cur_modifications = modifications;
 		for (int i = 0; i < steps; i++) {
-			EdgeChange & e = history.back();
+			EdgeChange & e = lastChange();
 			if (e.addition) {
 				if (!undoEnableEdge(e.id)) {
 					return false;
@@ -530,32 +667,57 @@ public:
 		return true;
 	}
 	/**
-	 * Returns a unique identifier for this algorithm.
+	 * Registers an algorithm that reads the history of this graph (via getChange()), and returns its unique identifier.
+	 * The algorithm must report how far it has read with updateHistoryConsumer() (or updateAlgorithmHistory());
+	 * changes are only discarded from the history once every consumer has read them (or once a consumer falls more
+	 * than the history clear interval behind, in which case historyAvailable() will return false for its position,
+	 * and it must recompute from scratch).
+	 * If alg is non-null, it may be asked to catch up on the history before a clear (see dynamic_history_clears).
 	 */
-	int addDynamicAlgorithm(DynamicGraphAlgorithm*alg){
+	int addHistoryConsumer(DynamicGraphAlgorithm*alg=nullptr){
 		dynamic_algs.push_back(alg);
-		dynamic_history_pos.push_back(0);
-		//n_dynamic_algs_updtodate+= (historySize()==0);
+		dynamic_history_pos.push_back(-1);
 		return dynamic_algs.size()-1;
 	}
 
-	void updateAlgorithmHistory(DynamicGraphAlgorithm * alg, int algorithmID, int historyPos){
+	int addDynamicAlgorithm(DynamicGraphAlgorithm*alg){
+		return addHistoryConsumer(alg);
+	}
+
+	void removeHistoryConsumer(int consumerID){
+		dynamic_algs[consumerID]=nullptr;
+		dynamic_history_pos[consumerID]=-1;
+	}
+
+	void updateHistoryConsumer(int consumerID, long historyPos){
+		dynamic_history_pos[consumerID]=historyPos;
+		if(historyPos>history_seen)
+			history_seen=historyPos;
+	}
+
+	void updateAlgorithmHistory(DynamicGraphAlgorithm * alg, int algorithmID, long historyPos){
 		assert(dynamic_algs[algorithmID]==alg);//sanity check
-		//bool was_uptodate = dynamic_history_pos[algorithmID]==historySize();
-		dynamic_history_pos[algorithmID]=historyPos;
-/*		if(!was_uptodate && historyPos ==historySize()){
-			dynamic_history_pos[algorithmID]++;
-		}*/
+		updateHistoryConsumer(algorithmID,historyPos);
 	}
 
 	EdgeChange & getChange(long historyPos){
-		assert(historyPos-history_offset>=0);
-		assert(historyPos-history_offset<history.size());
-		return history[historyPos-history_offset];
+		assert(historyPos>=history_offset);
+		assert(historyPos<history_end);
+		return historyAt(historyPos);
 	}
 
 	int historySize(){
-		return history.size() + history_offset;
+		return history_end;
+	}
+
+	//The position of the oldest change still in the history
+	long historyStart()const{
+		return history_offset;
+	}
+
+	//False if some of the changes from historyPos onward have been discarded
+	bool historyAvailable(long historyPos)const{
+		return historyPos>=history_offset;
 	}
 
 	int getCurrentHistory() {
@@ -564,55 +726,69 @@ public:
 	
 
 
+	/**
+	 * Discard changes from the history that all of the consumers have already read, once the history is longer than
+	 * historyClearInterval. If some consumer is so far behind that the history would still be longer than that,
+	 * then the oldest changes are discarded anyway, and that consumer will have to recompute from scratch.
+	 * If forceClear is set, then the history is cleared completely, and all the algorithms on this graph recompute from scratch
+	 * (historyclears is incremented).
+	 */
 	void clearHistory(bool forceClear = false) {
-		//long expect=std::max(1000,historyClearInterval*edges());
-		//check whether we can do a cheap history cleanup (without resetting all the dynamic algorithms)
 		if(disable_history_clears)
 			return;
-
-		if (history.size()
-				&& (forceClear
-						|| (history.size()
-								>= (std::min((long)history.max_size(), (adaptive_history_clear ?
-										std::max(1000L, historyClearInterval * edges()) : historyClearInterval)))))) {//){
-
-
-			if(!forceClear && dynamic_history_clears>0){
-				int n_uptodate=0;
-				for(int algorithmID = 0;algorithmID<dynamic_algs.size();algorithmID++){
-					if (dynamic_history_pos[algorithmID]!=historySize()){
-						if(dynamic_history_clears==2){
-							dynamic_algs[algorithmID]->updateHistory();
-							if (dynamic_history_pos[algorithmID]==historySize()){
-								n_uptodate++;
-							}
-						}
-					}else{
-						n_uptodate++;
-					}
-				}
-
-				if(n_uptodate==dynamic_algs.size()){
-					//we can skip this history clear.
-					history_offset=historySize();
-					skipped_historyclears++;
-					history.clear();
-					assert(history_offset == historySize());
-					return;
+		long interval = adaptive_history_clear ? std::max(1000L, historyClearInterval * edges()) : historyClearInterval;
+		//positions are stored as ints by many algorithms, so (rarely) start counting from 0 again
+		if (!forceClear && history_end > INT_MAX / 2)
+			forceClear=true;
+
+		if(forceClear){
+			if(history_end>0){
+				history_offset=0;
+				history_end=0;
+				history_seen=0;
+				for(long & pos:dynamic_history_pos)
+					pos=-1;
+				historyclears++;
+				if (outfile) {
+					fprintf(outfile, "clearHistory\n");
+					fflush(outfile);
 				}
 			}
+			return;
+		}
 
-			history_offset=0;
-			history.clear();
-			historyclears++;
+		if (historyLength() < interval)
+			return;
 
-			if (outfile) {
-				fprintf(outfile, "clearHistory\n");
-				fflush(outfile);
+		long slowest = slowestConsumer();
+		if (history_end - slowest >= interval && dynamic_history_clears == 2) {
+			for (int consumerID = 0; consumerID < dynamic_algs.size(); consumerID++) {
+				if (dynamic_algs[consumerID] && dynamic_history_pos[consumerID] >= 0 && dynamic_history_pos[consumerID] < history_end)
+					dynamic_algs[consumerID]->updateHistory();
 			}
-
+			slowest = slowestConsumer();
+		}
+		if (history_end - slowest >= interval) {
+			//some consumer has fallen too far behind; rather than let the history grow without bound, discard its unread changes.
+			slowest = history_end - interval / 2;
+			history_overflows++;
+		}
+		if (slowest > history_offset) {
+			history_offset = slowest;
+			skipped_historyclears++;
 		}
 	}
+private:
+	//The oldest position that some consumer has not yet read past
+	long slowestConsumer() const {
+		long slowest = history_end;
+		for (long pos : dynamic_history_pos) {
+			if (pos >= 0 && pos < slowest)
+				slowest = pos;
+		}
+		return std::max(slowest, history_offset);
+	}
+public:
 	//force a new modification
 	void invalidate() {
 		modifications++;
@@ -658,13 +834,24 @@ public:
 		next_id=0;
 
 
-		adjacency_list.clear();
-		inverted_adjacency_list.clear();
-		adjacency_undirected_list.clear();
-		all_edges.clear();
-		history.clear();
+		weights.clear();
+		edge_status_const.clear();
+		if (topology_ptr.use_count() > 1) {
+			//leave the other graphs' topology alone
+			topology_ptr = std::make_shared<Topology>();
+			topology = topology_ptr.get();
+		} else {
+			topology->adjacency_list.clear();
+			topology->inverted_adjacency_list.clear();
+			topology->adjacency_undirected_list.clear();
+			topology->all_edges.clear();
+		}
+		last_change.clear();
 		invalidate();
+		bool disabled = disable_history_clears;
+		disable_history_clears=false;
 		clearHistory(true);
+		disable_history_clears=disabled;
 	}
 	void copyTo(DynamicGraph & to){
 		to.clear();
@@ -674,12 +861,40 @@ public:
 		to.next_id = next_id;
 		to.edge_status = edge_status;
 		to.historyClearInterval=historyClearInterval;
-		to.adjacency_list = adjacency_list;
-		to.adjacency_undirected_list=adjacency_undirected_list;
-		to.all_edges =all_edges;
-		to.inverted_adjacency_list=inverted_adjacency_list;
+		to.weights = weights;
+		to.edge_status_const = edge_status_const;
+		to.last_change.resize(last_change.size(), -1);
+		*to.topology = *topology;
+	}
+
+	/**
+	 * Use the same topology as another graph, instead of keeping a separate copy of all of the adjacency lists.
+	 * Must be called before any nodes or edges are added to this graph; after that, each node and edge must be added
+	 * to all of the graphs sharing the topology (in any order, but with the same edge IDs and endpoints).
+	 * The graphs still enable and disable their edges, and set their weights, independently.
+	 */
+	void shareTopology(DynamicGraph & other) {
+		assert(num_nodes == 0);
+		assert(num_edges == 0);
+		topology_ptr = other.topology_ptr;
+		topology = topology_ptr.get();
+	}
 
+	bool sharesTopology() const {
+		return topology_ptr.use_count() > 1;
+	}
+
+	//Approximate number of bytes allocated for the (possibly shared) topology of this graph
+	size_t topologyMemoryUsage() const {
+		return topology->memoryUsage();
+	}
 
+	//Approximate number of bytes allocated for the state of this graph, not including its topology
+	size_t memoryUsage() const {
+		return sizeof(DynamicGraph) + edge_status.capacity() / 8 + edge_status_const.capacity() / 8
+				+ weights.capacity() * sizeof(Weight) + last_change.capacity() * sizeof(long)
+				+ history.capacity() * sizeof(EdgeChange) + dynamic_algs.capacity() * sizeof(DynamicGraphAlgorithm*)
+				+ dynamic_history_pos.capacity() * sizeof(long);
 	}
 
 };
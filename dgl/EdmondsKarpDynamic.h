@@ -226,7 +226,7 @@ public:
 			assert(curflow==expected_flow);
 #endif
 			return curflow;
-		} else if (last_modification <= 0 || g.historyclears != last_history_clear || g.changed()) {
+		} else if (last_modification <= 0 || g.historyclears != last_history_clear || !g.historyAvailable(history_qhead) || g.changed()) {
 			F.clear();
 			F.resize(g.edges());
 			changed.resize(g.nEdgeIDs());
@@ -246,6 +246,7 @@ public:
 			dbg_print_graph(s, t, -1, -1);
 			f = maxFlow_p(s, t);
 			dbg_print_graph(s, t, -1, -1);
+			history_qhead = g.historySize();
 		}
 		
 #ifdef DEBUG_MAXFLOW
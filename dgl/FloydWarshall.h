@@ -31,6 +31,15 @@
 
 namespace dgl {
 
+/**
+ * All-pairs shortest paths (in number of edges) by Floyd-Warshall.
+ *
+ * Distances are stored in a single flat, row-major n*n array. Full recomputation uses the cache-blocked
+ * (tiled) formulation of Floyd-Warshall, whose inner loop is a branch-free min-plus update over a contiguous
+ * row segment that the compiler can vectorize.
+ * If only edges have been enabled since the last update (and not too many of them), each enabled edge (u,v)
+ * is instead repaired incrementally in O(n^2), by relaxing every row through u->v.
+ */
 template<typename Weight, class Status = AllPairs::NullStatus>
 class FloydWarshall: public AllPairs {
 public:
@@ -43,6 +52,7 @@ public:
 	int history_qhead;
 
 	int last_history_clear;
+	int history_id;
 
 	std::vector<int> sources;
 	int INF;
@@ -52,8 +62,15 @@ public:
 //	std::vector<int> check;
 	const int reportPolarity;
 
-	std::vector<std::vector<int> > dist;
-	std::vector<std::vector<int> > next;
+	//Number of nodes (and row stride) of dist and next
+	int n = 0;
+	//dist[i*n+j] is the distance from i to j
+	std::vector<int> dist;
+	//next[i*n+j] is an intermediate node on a shortest path from i to j, or -1 if that path is a single edge
+	std::vector<int> next;
+
+	//Side length of the square tiles used by the blocked update
+	static const int tile_size = 64;
 
 public:
 	int stats_full_updates;
@@ -70,6 +87,7 @@ public:
 	FloydWarshall(DynamicGraph<Weight> & graph, Status & _status = AllPairs::nullStatus, int _reportPolarity = 0) :
 			g(graph), status(_status), last_modification(-1), last_addition(-1), last_deletion(-1), history_qhead(0), last_history_clear(
 					0), INF(0), reportPolarity(0) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		stats_full_updates = 0;
@@ -98,16 +116,9 @@ public:
 		for (int i = 0; i < n; i++)
 			order.push_back(i);
 		INF = g.nodes() + 1;
-		if (dist.size() < n) {
-			dist.resize(n);
-			for (int i = 0; i < dist.size(); i++)
-				dist[i].resize(n);
-		}
-		if (next.size()<n){
-			next.resize(n);
-			for (int i = 0; i < next.size(); i++)
-				next[i].resize(n);
-		}
+		this->n = n;
+		dist.resize(n * n);
+		next.resize(n * n);
 	}
 	
 	struct lt_key {
@@ -126,53 +137,125 @@ public:
 		return num_updates;
 	}
 	
-	void update() {
-		
-		stats_full_updates++;
-		
-		if (last_modification > 0 && g.modifications == last_modification) {
-			stats_skipped_updates++;
-			return;
-		}
-		
-		if (last_deletion == g.deletions) {
-			stats_num_skipable_deletions++;
+private:
+	//Relax all paths from rows [i0,i1) to columns [j0,j1) through the intermediate nodes [k0,k1).
+	//The inner loop is written without branches so that it can be vectorized.
+	void relaxTile(int i0, int i1, int j0, int j1, int k0, int k1) {
+		for (int k = k0; k < k1; k++) {
+			const int * row_k = &dist[k * n];
+			for (int i = i0; i < i1; i++) {
+				int * row_i = &dist[i * n];
+				int * next_i = &next[i * n];
+				int d_ik = row_i[k];
+				if (d_ik >= INF)
+					continue;
+				for (int j = j0; j < j1; j++) {
+					int d = d_ik + row_k[j];
+					bool shorter = d < row_i[j];
+					row_i[j] = shorter ? d : row_i[j];
+					next_i[j] = shorter ? k : next_i[j];
+				}
+			}
 		}
-		
+	}
+	
+	//Blocked Floyd-Warshall: for each diagonal tile, first close the tile itself, then the tiles in its row
+	//and column, and then all remaining tiles.
+	void recompute() {
 		setNodes(g.nodes());
 		
-		for (int i = 0; i < g.nodes(); i++) {
-			for (int j = 0; j < g.nodes(); j++) {
-				next[i][j] = -1;
-				dist[i][j] = INF;
-			}
-			dist[i][i] = 0;
-		}
+		std::fill(dist.begin(), dist.end(), INF);
+		std::fill(next.begin(), next.end(), -1);
+		for (int i = 0; i < n; i++)
+			dist[i * n + i] = 0;
 		
 		for (int i = 0; i < g.edges(); i++) {
 			if (g.hasEdge(i) && g.edgeEnabled(i)) {
 				int u = g.getEdge(i).from;
 				int v = g.getEdge(i).to;
 				if (u != v)
-					dist[u][v] = 1;
+					dist[u * n + v] = 1;
 			}
 		}
 		
-		//for(int l = 0;l<sources.size();l++){
-		//	int k = sources[l];
-		for (int k = 0; k < g.nodes(); k++) {
-			for (int i = 0; i < g.nodes(); i++) {
-				for (int j = 0; j < g.nodes(); j++) {
-					int d = dist[i][k] + dist[k][j];
-					if (d < dist[i][j]) {
-						dist[i][j] = d;
-						next[i][j] = k;
-					}
+		for (int k0 = 0; k0 < n; k0 += tile_size) {
+			int k1 = std::min(k0 + tile_size, n);
+			relaxTile(k0, k1, k0, k1, k0, k1);
+			for (int t0 = 0; t0 < n; t0 += tile_size) {
+				if (t0 == k0)
+					continue;
+				int t1 = std::min(t0 + tile_size, n);
+				relaxTile(k0, k1, t0, t1, k0, k1);
+				relaxTile(t0, t1, k0, k1, k0, k1);
+			}
+			for (int i0 = 0; i0 < n; i0 += tile_size) {
+				if (i0 == k0)
+					continue;
+				int i1 = std::min(i0 + tile_size, n);
+				for (int j0 = 0; j0 < n; j0 += tile_size) {
+					if (j0 == k0)
+						continue;
+					relaxTile(i0, i1, j0, std::min(j0 + tile_size, n), k0, k1);
 				}
 			}
 		}
+	}
+	
+	//Repair all distances after the edge (u,v) was enabled: the only new shortest paths are i -> u -> v -> j.
+	//Neither row v nor column u can change, so every row can be relaxed independently in O(n).
+	void enableEdge(int u, int v) {
+		if (u == v || dist[u * n + v] <= 1)
+			return;
+		const int * row_v = &dist[v * n];
+		for (int i = 0; i < n; i++) {
+			int d_iu = dist[i * n + u];
+			if (d_iu >= INF)
+				continue;
+			int * row_i = &dist[i * n];
+			int * next_i = &next[i * n];
+			int d_base = d_iu + 1;
+			int via = (i == u) ? v : u;
+			for (int j = 0; j < n; j++) {
+				int d = d_base + row_v[j];
+				bool shorter = d < row_i[j];
+				row_i[j] = shorter ? d : row_i[j];
+				next_i[j] = shorter ? via : next_i[j];
+			}
+		}
+		next[u * n + v] = -1;
+	}
+	
+public:
+	void update() {
+		
+		if (last_modification > 0 && g.modifications == last_modification) {
+			stats_skipped_updates++;
+			return;
+		}
+		
+		if (last_deletion == g.deletions) {
+			stats_num_skipable_deletions++;
+		}
+		
+		if (last_modification > 0 && last_deletion == g.deletions && last_history_clear == g.historyclears
+				&& n == g.nodes() && g.historyAvailable(history_qhead) && history_qhead <= g.historySize()
+				&& g.historySize() - history_qhead <= mod_percentage * n) {
+			//only edges have been enabled since the last update
+			stats_fast_updates++;
+			for (int i = history_qhead; i < g.historySize(); i++) {
+				int edgeid = g.getChange(i).id;
+				if (g.getChange(i).addition && g.edgeEnabled(edgeid)) {
+					enableEdge(g.getEdge(edgeid).from, g.getEdge(edgeid).to);
+				}
+			}
+		} else {
+			stats_full_updates++;
+			recompute();
+		}
+		
 		for (int i = 0; i < sources.size(); i++) {
 			int s = sources[i];
+			const int * row_s = &dist[s * n];
 			//sort(order,lt_key(dist[s]));//disabled because it is NOT required
 			for (int j = 0; j < order.size(); j++) {
 				int u = j;		// order[j];
@@ -181,23 +264,14 @@ public:
 				 }*/
 				//Wrong. This is only required if we are returning learnt clauses that include other reachability lits.
 				//it is crucial to return the nodes in order of distance, so that they are enqueued in the correct order in the solver.
-				if (dist[s][u] >= INF && reportPolarity < 1) {
+				if (row_s[u] >= INF && reportPolarity < 1) {
 					status.setReachable(s, u, false);
 					status.setMininumDistance(s, u, false, INF);
-				} else if (dist[s][u] < INF && reportPolarity > -1) {
+				} else if (row_s[u] < INF && reportPolarity > -1) {
 					status.setReachable(s, u, true);
-					status.setMininumDistance(s, u, true, dist[s][u]);
+					status.setMininumDistance(s, u, true, row_s[u]);
 				}
 			}
-			/*	for(int u = 0;u<g.nodes();u++){
-			 if(dist[s][u]>=INF && reportPolarity<1){
-			 //status.setReachable(s,u,false);
-			 //status.setMininumDistance(s,u,false,INF);
-			 }else if(dist[s][u]<INF && reportPolarity>-1){
-			 //status.setReachable(s,u,true);
-			 //status.setMininumDistance(s,u,true,dist[s][u]);
-			 }
-			 }*/
 		}
 		assert(dbg_uptodate());
 		num_updates++;
@@ -206,6 +280,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 	}
@@ -218,8 +293,8 @@ public:
 		path.push_back(to);
 	}
 	void getPath_private(int from, int to, std::vector<int> & path) {
-		assert(dist[from][to] < INF);
-		int intermediate = next[from][to];
+		assert(dist[from * n + to] < INF);
+		int intermediate = next[from * n + to];
 		if (intermediate > -1) {
 			getPath_private(from, intermediate, path);
 			path.push_back(intermediate);
@@ -269,7 +344,7 @@ public:
 	}
 	
 	bool connected_unsafe(int from, int t) {
-		return dist[from][t] < INF;
+		return dist[from * n + t] < INF;
 	}
 	bool connected_unchecked(int from, int t) {
 		assert(last_modification == g.modifications);
@@ -281,17 +356,17 @@ public:
 		
 		assert(dbg_uptodate());
 		
-		return dist[from][t] < INF;
+		return dist[from * n + t] < INF;
 	}
 	int distance(int from, int t) {
 		if (connected(from, t))
-			return dist[from][t];
+			return dist[from * n + t];
 		else
 			return INF;
 	}
 	int distance_unsafe(int from, int t) {
 		if (connected_unsafe(from, t))
-			return dist[from][t];
+			return dist[from * n + t];
 		else
 			return INF;
 	}
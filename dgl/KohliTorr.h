@@ -528,8 +528,12 @@ public:
 		} else if (!kt || last_modification <= 0 || kt->get_node_num() != g.nodes()
 				|| edge_enabled.size() != g.edges()) {
 			initKT();
-		} else if (g.historyclears != last_history_clear || g.changed()) {
-			stats_reinits++;
+			//the history may not reach back far enough to replay, so load the enabled edges from the graph below
+			history_qhead = -1;
+		}
+		if (history_qhead < 0 || g.historyclears != last_history_clear || !g.historyAvailable(history_qhead) || g.changed()) {
+			if (history_qhead >= 0)
+				stats_reinits++;
 			flow_needs_recalc = true;
 			for (int edgeid = 0; edgeid < g.edges(); edgeid++) {
 				if (!g.hasEdge(edgeid) || g.selfLoop(edgeid))
@@ -84,6 +84,7 @@ public:
 	bool cycleComputed=false;
 	bool has_topo=false;
 	int nextOrd =0;
+	int cycle_start=-1;//while unwinding sortVisit after finding a cycle, the node the cycle starts at (or -1, once the cycle is complete)
 
 	int lower_bound=0;
 	int upper_bound=0;
@@ -246,6 +247,21 @@ private:
 		}
 		int from = g.getEdge(edgeID).from;
 		int to = g.getEdge(edgeID).to;
+		if(from==to){
+			//a self loop is a cycle on its own
+			has_cycle=true;
+			cycleComputed=true;
+			num_strict_sccs=1;
+			assert(cycle.size()==0);
+			cycle.push_back(edgeID);
+			in_cycle[from]=true;
+			if(force_dag){
+				has_cycle=false;
+			}else{
+				has_topo=false;
+			}
+			return;
+		}
 		 lower_bound = ord[to];
 		 upper_bound = ord[from];
 		if(lower_bound<upper_bound){
@@ -272,6 +288,10 @@ private:
 #endif
 				l_xy_F.clear();
 				l_xy_B.clear();
+				//dfs_forward found the path to->...->from; the new edge closes the cycle.
+				cycle.push_back(edgeID);
+				in_cycle[from]=true;
+				in_cycle[to]=true;
 				if(force_dag){
 					has_cycle=false;//ignore the edge that caused a cycle to be introduced, because it is guaranteed that any edges creating cycles will be removed.
 				}else{
@@ -426,7 +446,7 @@ public:
 		if(local_it==5){
 			int a=1;
 		}
-		if(last_modification<=0 || g.historyclears != last_history_clear  || g.changed()){
+		if(last_modification<=0 || g.historyclears != last_history_clear || !g.historyAvailable(history_qhead) || g.changed()){
 			setNodes(g.nodes());
 			cycleComputed=false;
 			has_cycle=false;
@@ -438,6 +458,7 @@ public:
 			if(!topologicalSort()){
 				updateSCCs();
 			}
+			history_qhead = g.historySize();
 		}
 
 		for (int i = history_qhead; i < g.historySize(); i++) {
@@ -475,7 +496,7 @@ private:
 			cycleComputed=true;
 			num_strict_sccs=1;
 			assert(cycle.size()==0);
-
+			cycle_start=node;
 
 			return false;
 		}
@@ -487,9 +508,14 @@ private:
 					if(!sortVisit(g.incident(node,j).node)){
 						assert(has_cycle);
 						tmp_mark[node]=false;
-						cycle.push_back(edgeID);
-						in_cycle[node]=true;
-						in_cycle[g.incident(node,j).node]=true;
+						//only the edges from cycle_start onwards are part of the cycle; the rest of the dfs path leads into it.
+						if(cycle_start>=0){
+							cycle.push_back(edgeID);
+							in_cycle[node]=true;
+							in_cycle[g.incident(node,j).node]=true;
+							if(node==cycle_start)
+								cycle_start=-1;
+						}
 						return false;
 					}
 				}
@@ -141,7 +141,7 @@ public:
 			stats_skipped_updates++;
 			return;
 		}
-		if (last_modification <= 0 || g.changed() || last_history_clear != g.historyclears) {
+		if (last_modification <= 0 || g.changed() || last_history_clear != g.historyclears || g.edge_increases > last_modification) {
 			INF = 1;	//g.nodes()+1;
 					
 			for (auto & w : g.getWeights())
@@ -571,8 +571,8 @@ public:
 			}
 		}
 		edgeInShortestPathGraph.resize(g.nEdgeIDs());
-		if (last_history_clear != g.historyclears) {
-			history_qhead = 0;
+		if (last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
+			history_qhead = g.historyStart();
 			last_history_clear = g.historyclears;
 			
 		}
@@ -615,8 +615,8 @@ public:
 		last_modification = g.modifications;
 		last_deletion = g.deletions;
 		last_addition = g.additions;
-		g.updateAlgorithmHistory(this,alg_id,history_qhead);
 		history_qhead = g.historySize();
+		g.updateAlgorithmHistory(this,alg_id,history_qhead);
 		last_history_clear = g.historyclears;
 		
 		;
@@ -1349,8 +1349,8 @@ public:
 			}
 		}
 		
-		if (last_history_clear != g.historyclears) {
-			history_qhead = 0;
+		if (last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
+			history_qhead = g.historyStart();
 			last_history_clear = g.historyclears;
 			for (int edgeid = 0; edgeid < g.edges(); edgeid++) {
 				if (g.edgeEnabled(edgeid)) {
@@ -667,7 +667,7 @@ public:
 		}
 
 		assert(components_to_visit.size() == 0);
-		if (last_modification <= 0 || g.changed() || last_history_clear != g.historyclears) {
+		if (last_modification <= 0 || g.changed() || last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
 			INF = 1;				//g.nodes()+1;
 			setNodes(g.nodes());
 
@@ -0,0 +1,111 @@
+/*************************************************************************************[RadixHeap.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef DGL_RADIXHEAP_H_
+#define DGL_RADIXHEAP_H_
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dgl {
+//=================================================================================================
+// A monotone radix heap over non-negative integer keys.
+// Keys pushed must be no smaller than the last key popped (which holds for Dijkstra with
+// non-negative edge weights). There is no decrease-key: callers push a node again with its
+// improved key, and skip stale entries when they are popped (the popped key no longer matches
+// the node's current distance).
+class RadixHeap {
+	typedef std::pair<uint64_t, int> Entry;
+	static const int n_buckets = 65;
+	std::vector<Entry> buckets[n_buckets];
+	uint64_t last = 0;
+	int sz = 0;
+
+	inline int bucketIndex(uint64_t key) const {
+		return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+	}
+
+	// Move the contents of the smallest non-empty bucket into lower buckets, relative to its minimum key.
+	void redistribute() {
+		int b = 1;
+		while (buckets[b].empty())
+			b++;
+		uint64_t new_last = buckets[b][0].first;
+		for (const Entry & e : buckets[b]) {
+			if (e.first < new_last)
+				new_last = e.first;
+		}
+		last = new_last;
+		for (const Entry & e : buckets[b]) {
+			int nb = bucketIndex(e.first);
+			assert(nb < b);
+			buckets[nb].push_back(e);
+		}
+		buckets[b].clear();
+	}
+
+public:
+	int size() const {
+		return sz;
+	}
+	bool empty() const {
+		return sz == 0;
+	}
+
+	void push(uint64_t key, int value) {
+		assert(key >= last);
+		buckets[bucketIndex(key)].push_back(Entry(key, value));
+		sz++;
+	}
+
+	// The smallest key currently in the heap. The heap must be non-empty.
+	uint64_t topKey() {
+		assert(sz > 0);
+		if (buckets[0].empty())
+			redistribute();
+		return last;
+	}
+
+	// Remove an entry with the smallest key, returning its value (and its key through 'key').
+	int pop(uint64_t & key) {
+		assert(sz > 0);
+		if (buckets[0].empty())
+			redistribute();
+		key = last;
+		int v = buckets[0].back().second;
+		buckets[0].pop_back();
+		sz--;
+		return v;
+	}
+
+	void clear() {
+		if (sz > 0) {
+			for (int i = 0; i < n_buckets; i++)
+				buckets[i].clear();
+		}
+		last = 0;
+		sz = 0;
+	}
+};
+
+}
+#endif
@@ -8,7 +8,6 @@ import random
 import sys
 
 
-print("Note: currently, pseudo-Boolean encodings rely on MinisatPB (a variant of Minisat+), which must be installed and on the path (as 'minisatpb') in order for MonoSAT to use it.")
 vars=[]
 for v in range(10):
     vars.append(Var())
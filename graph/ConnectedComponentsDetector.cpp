@@ -419,9 +419,9 @@ void ConnectedComponentsDetector<Weight>::buildNodesNotConnectedReason(int sourc
 			assert(!outer->dbg_reachable(source, u, false));
 			//assert(!negative_reach_detector->connected_unsafe(u));
 			//Ok, then add all its incoming disabled edges to the cut, and visit any unseen, non-disabled incoming.edges()
-			for (int i = 0; i < outer->inv_adj[u].size(); i++) {
-				int v = outer->inv_adj[u][i].v;
-				int from = outer->inv_adj[u][i].from;
+			for (int i = 0; i < outer->nIncomingEdges(u); i++) {
+				int v = outer->getIncomingEdge(u, i).v;
+				int from = outer->getIncomingEdge(u, i).from;
 				int edge_num = outer->getEdgeID(v);								// v-outer->min_edge_var;
 				if (from == u) {
 					assert(outer->edge_list[edge_num].to == u);
@@ -429,7 +429,7 @@ void ConnectedComponentsDetector<Weight>::buildNodesNotConnectedReason(int sourc
 					continue;				//Self loops are allowed, but just make sure nothing got flipped around...
 				}
 				assert(from != u);
-				assert(outer->inv_adj[u][i].to == u);
+				assert(outer->getIncomingEdge(u, i).to == u);
 				//Note: the variable has to not only be assigned false, but assigned false earlier in the trail than the reach variable...
 				
 				if (outer->value(v) == l_False) {
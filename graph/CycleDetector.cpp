@@ -194,7 +194,7 @@ bool CycleDetector<Weight>::propagate(vec<Lit> & conflict) {
 				//do nothing
 			} else if (outer->value(l) == l_Undef) {
 				//trail.push(Assignment(false,false,detectorID,0,var(l)));
-				outer->enqueue(l, no_directed_cycle_marker);
+				outer->enqueue(l, directed_cycle_marker);
 			} else if (outer->value(l) == l_False) {
 				conflict.push(l);
 				buildDirectedCycleReason(conflict);
@@ -207,7 +207,7 @@ bool CycleDetector<Weight>::propagate(vec<Lit> & conflict) {
 				//do nothing
 			} else if (outer->value(l) == l_Undef) {
 				//trail.push(Assignment(false,true,detectorID,0,var(l)));
-				outer->enqueue(l, directed_cycle_marker);
+				outer->enqueue(l, no_directed_cycle_marker);
 			} else if (outer->value(l) == l_False) {
 				conflict.push(l);
 				buildNoDirectedCycleReason(conflict);
@@ -219,13 +219,13 @@ bool CycleDetector<Weight>::propagate(vec<Lit> & conflict) {
 		
 		if (outer->value(undirected_acyclic_lit) !=l_False && underapprox_undirected_cycle_detector->hasUndirectedCycle()) {
 
-			Lit l = ~directed_acyclic_lit;
+			Lit l = ~undirected_acyclic_lit;
 			
 			if (outer->value(l) == l_True) {
 				//do nothing
 			} else if (outer->value(l) == l_Undef) {
 				//trail.push(Assignment(false,false,detectorID,0,var(l)));
-				outer->enqueue(l, no_undirected_cycle_marker);
+				outer->enqueue(l, undirected_cycle_marker);
 			} else if (outer->value(l) == l_False) {
 				conflict.push(l);
 				buildUndirectedCycleReason(conflict);
@@ -238,7 +238,7 @@ bool CycleDetector<Weight>::propagate(vec<Lit> & conflict) {
 				//do nothing
 			} else if (outer->value(l) == l_Undef) {
 				//trail.push(Assignment(false,true,detectorID,0,var(l)));
-				outer->enqueue(l, undirected_cycle_marker);
+				outer->enqueue(l, no_undirected_cycle_marker);
 			} else if (outer->value(l) == l_False) {
 				conflict.push(l);
 				buildNoUndirectedCycleReason(conflict);
@@ -25,6 +25,7 @@
 #include "GraphTheoryTypes.h"
 #include "mtl/Vec.h"
 #include "core/Config.h"
+#include "utils/Profile.h"
 #include <cstdio>
 #include <iostream>
 namespace Monosat {
@@ -57,6 +58,25 @@ public:
 	long stats_under_clause_length = 0;
 	long stats_over_clause_length = 0;
 
+	//Cycle counters for the hot paths; these replace rtime() pairs around propagate/decide/update.
+	struct Profile {
+		ProfileCounter propagate;
+		ProfileCounter decide;
+		ProfileCounter under_update;
+		ProfileCounter over_update;
+		ProfileCounter reason;
+	} profile;
+
+	double underUpdateTime() const {
+		return stats_under_update_time + profile.under_update.seconds();
+	}
+	double overUpdateTime() const {
+		return stats_over_update_time + profile.over_update.seconds();
+	}
+	double decideTime() const {
+		return stats_decide_time + profile.decide.seconds();
+	}
+
 	int getID() {
 		return detectorID;
 	}
@@ -70,13 +90,16 @@ public:
 			printf("Detector %d (%s):\n", getID(), getName());
 			//printf("Updates: %d (under), %d over\n", stats_under_updates, stats_over_updates);
 			printf("\tUnder-approx updates: %ld (%ld skipped) (%f s total, %f s avg)\n", stats_under_updates,
-					stats_skipped_under_updates, (double) stats_under_update_time,
-					(double) stats_under_update_time / (double) (stats_under_updates + 1));
+					stats_skipped_under_updates, underUpdateTime(),
+					underUpdateTime() / (double) (stats_under_updates + 1));
 			printf("\tOver-approx updates: %ld (%ld skipped)  (%f s total, %f s avg)\n", stats_over_updates,
-					stats_skipped_over_updates, (double) stats_over_update_time,
-					(double) stats_over_update_time / (double) (stats_over_updates + 1));
-			printf("\tTheory Decisions: %ld (%f s total, %f s avg, %ld priority)\n", stats_decisions, (double) stats_decide_time,
-					(double) stats_decide_time / (double) (stats_decisions + 1),n_stats_priority_decisions);
+					stats_skipped_over_updates, overUpdateTime(),
+					overUpdateTime() / (double) (stats_over_updates + 1));
+			printf("\tTheory Decisions: %ld (%f s total, %f s avg, %ld priority)\n", stats_decisions, decideTime(),
+					decideTime() / (double) (stats_decisions + 1),n_stats_priority_decisions);
+			printf("\tPropagations: %llu (%f s total), reasons: %llu (%f s total)\n",
+					(unsigned long long) profile.propagate.calls, profile.propagate.seconds(),
+					(unsigned long long) profile.reason.calls, profile.reason.seconds());
 			printf(
 					"\tConflicts (under,over): %ld (clause literals: %ld), %ld, (clause literals: %ld), (under time %f s, over time %f s)\n",
 					stats_under_conflicts, stats_under_clause_length, stats_over_conflicts, stats_over_clause_length,
@@ -85,6 +108,25 @@ public:
 		}
 	}
 	
+	//Write this detector's counters as a single JSON object. Safe (if not exact) to call from another thread mid-solve.
+	virtual void writeStatsJSON(std::ostream & out) {
+		out << "{\"id\":" << getID() << ",\"name\":\"" << getName() << "\"";
+		out << ",\"propagate\":";
+		profile.propagate.writeJSON(out);
+		out << ",\"decide\":";
+		profile.decide.writeJSON(out);
+		//not every detector times its updates with the profile counters yet, so report the combined times
+		out << ",\"under_update\":{\"calls\":" << stats_under_updates << ",\"seconds\":" << underUpdateTime() << "}";
+		out << ",\"over_update\":{\"calls\":" << stats_over_updates << ",\"seconds\":" << overUpdateTime() << "}";
+		out << ",\"reason\":";
+		profile.reason.writeJSON(out);
+		out << ",\"decisions\":" << stats_decisions;
+		out << ",\"skipped_under_updates\":" << stats_skipped_under_updates << ",\"skipped_over_updates\":"
+				<< stats_skipped_over_updates;
+		out << ",\"under_conflicts\":" << stats_under_conflicts << ",\"over_conflicts\":" << stats_over_conflicts;
+		out << "}";
+	}
+
 	virtual void printSolution(std::ostream & write_to = std::cout) {
 	}
 	
@@ -144,32 +144,11 @@ DistanceDetector<Weight>::DistanceDetector(int _detectorID, GraphTheorySolver<We
 	positiveDistanceStatus = new DistanceDetector<Weight>::DistanceStatus(*this, true);
 	negativeDistanceStatus = new DistanceDetector<Weight>::DistanceStatus(*this, false);
 	
-	if (outer->hasBitVectorEdges()){
-		printf("Note: falling back on Dijkstra for shortest paths, because edge weights are bitvectors\n");
-		//ramel reps doesn't support bvs yet
-		underapprox_weighted_distance_detector =
-		new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(from, _g,
-				*positiveDistanceStatus, 0);
-		overapprox_weighted_distance_detector = new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(
-				from, _antig,  *negativeDistanceStatus, 0);
-		underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
-	}else if (  distalg == DistAlg::ALG_RAMAL_REPS) {
-
-		underapprox_weighted_distance_detector =
-				new RamalReps<Weight, typename DistanceDetector<Weight>::DistanceStatus>(from, _g,
-						*(positiveDistanceStatus), 0);
-		overapprox_weighted_distance_detector =
-				new RamalReps<Weight, typename DistanceDetector<Weight>::DistanceStatus>(from, _antig,
-						*(negativeDistanceStatus), 0);
-		underapprox_weighted_path_detector = new Dijkstra<Weight>(from, _g);
-	} else {
-		underapprox_weighted_distance_detector =
-				new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(from, _g,
-						*positiveDistanceStatus, 0);
-		overapprox_weighted_distance_detector = new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(
-				from, _antig,  *negativeDistanceStatus, 0);
-		underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
+	if (opt_dist_alt_targets > 0 && (outer->hasBitVectorEdges() || distalg != DistAlg::ALG_RAMAL_REPS)) {
+		//use goal-directed search in place of (non-incremental) Dijkstra, as long as there are few targets
+		alt_landmarks = new ALTLandmarks<Weight>(_antig);
 	}
+	buildWeightedDetectors();
 	
 	if (opt_conflict_min_cut) {
 		if (mincutalg == MinCutAlg::ALG_EDKARP_DYN) {
@@ -200,6 +179,65 @@ DistanceDetector<Weight>::DistanceDetector(int _detectorID, GraphTheorySolver<We
 	weighted_overprop_marker = outer->newReasonMarker(getID());
 }
 
+template<typename Weight>
+void DistanceDetector<Weight>::buildWeightedDetectors() {
+	if (underapprox_weighted_path_detector && underapprox_weighted_path_detector != underapprox_weighted_distance_detector)
+		delete underapprox_weighted_path_detector;
+	if (underapprox_weighted_distance_detector)
+		delete underapprox_weighted_distance_detector;
+	if (overapprox_weighted_distance_detector)
+		delete overapprox_weighted_distance_detector;
+	
+	if (alt_landmarks) {
+		//Few targets: search towards them only, guided by lower bounds computed on g_over at level 0
+		//(which are also lower bounds for g_under, as its edges are a subset of g_over's, with weights at least as large)
+		underapprox_weighted_distance_detector = new ALTDijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(
+				source, g_under, *alt_landmarks, *positiveDistanceStatus, 0);
+		overapprox_weighted_distance_detector = new ALTDijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(
+				source, g_over, *alt_landmarks, *negativeDistanceStatus, 0);
+		underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
+	}else if (outer->hasBitVectorEdges()){
+		printf("Note: falling back on Dijkstra for shortest paths, because edge weights are bitvectors\n");
+		//ramel reps doesn't support bvs yet
+		underapprox_weighted_distance_detector =
+		new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(source, g_under,
+				*positiveDistanceStatus, 0);
+		overapprox_weighted_distance_detector = new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(
+				source, g_over,  *negativeDistanceStatus, 0);
+		underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
+	}else if (  distalg == DistAlg::ALG_RAMAL_REPS) {
+
+		underapprox_weighted_distance_detector =
+				new RamalReps<Weight, typename DistanceDetector<Weight>::DistanceStatus>(source, g_under,
+						*(positiveDistanceStatus), 0);
+		overapprox_weighted_distance_detector =
+				new RamalReps<Weight, typename DistanceDetector<Weight>::DistanceStatus>(source, g_over,
+						*(negativeDistanceStatus), 0);
+		underapprox_weighted_path_detector = new Dijkstra<Weight>(source, g_under);
+	} else {
+		underapprox_weighted_distance_detector =
+				new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(source, g_under,
+						*positiveDistanceStatus, 0);
+		overapprox_weighted_distance_detector = new Dijkstra<Weight, typename DistanceDetector<Weight>::DistanceStatus>(
+				source, g_over,  *negativeDistanceStatus, 0);
+		underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
+	}
+	
+}
+
+template<typename Weight>
+void DistanceDetector<Weight>::addWeightedTarget(int to) {
+	if (!alt_landmarks)
+		return;
+	alt_landmarks->addTarget(to);
+	if (alt_landmarks->nTargets() > opt_dist_alt_targets) {
+		//too many targets for goal-directed search to pay off; compute full single-source distances instead
+		delete alt_landmarks;
+		alt_landmarks = nullptr;
+		buildWeightedDetectors();
+	}
+}
+
 template<typename Weight>
 void DistanceDetector<Weight>::buildUnweightedSATConstraints(bool onlyUnderApprox, int within_steps) {
 	if (within_steps < 0)
@@ -394,7 +432,8 @@ void DistanceDetector<Weight>::buildUnweightedSATConstraints(bool onlyUnderAppro
 			for (int j = 0; j < g_under.nodes(); j++) {
 				Lit r_cur = reaches[j];
 
-				for (Edge & e : outer->inv_adj[j]) {
+				for (int k = 0; k < outer->nIncomingEdges(j); k++) {
+					Edge e = outer->getIncomingEdge(j, k);
 					if (outer->value(unweighted_sat_lits.last()[e.to]) == l_True) {
 						//do nothing
 					} else if (outer->value(reaches[e.from]) == l_False) {
@@ -443,6 +482,7 @@ void DistanceDetector<Weight>::addWeightedShortestPathLit(int from, int to, Var
 	Var reach_var = outer->newVar(outer_reach_var, getID());
 	assert(from == source);
 	weighted_dist_lits.push(WeightedDistLit { mkLit(reach_var), to, within_distance,strictComparison });
+	addWeightedTarget(to);
 	//sort(weighted_dist_lits);
 }
 
@@ -454,6 +494,7 @@ void DistanceDetector<Weight>::addWeightedShortestPathBVLit(int from, int to, Va
 	Var reach_var = outer->newVar(outer_reach_var, getID());
 	assert(from == source);
 	weighted_dist_bv_lits.push(WeightedDistBVLit { mkLit(reach_var), to, bv, strictComparison });
+	addWeightedTarget(to);
 	//sort(weighted_dist_lits);
 }
 
@@ -700,10 +741,10 @@ void DistanceDetector<Weight>::buildUnweightedDistanceGTReason(int node, int wit
 			assert(seen[u]);
 			//assert(negative_reach_detector->distance_unsafe(u)>d);
 			//Ok, then add all its incoming disabled edges to the cut, and visit any unseen, non-disabled incoming.edges()
-			for (int i = 0; i < outer->inv_adj[u].size(); i++) {
-				int v = outer->inv_adj[u][i].v;
-				int from = outer->inv_adj[u][i].from;
-				assert(outer->inv_adj[u][i].to == u);
+			for (int i = 0; i < outer->nIncomingEdges(u); i++) {
+				int v = outer->getIncomingEdge(u, i).v;
+				int from = outer->getIncomingEdge(u, i).from;
+				assert(outer->getIncomingEdge(u, i).to == u);
 				//Note: the variable has to not only be assigned false, but assigned false earlier in the trail than the reach variable...
 				int edge_num = outer->getEdgeID(v);				// v-outer->min_edge_var;
 						
@@ -956,11 +997,11 @@ void DistanceDetector<Weight>::buildDistanceGTReason(int to, Weight & min_distan
 			to_visit.pop();
 			assert(seen[u]);
 			//add all of this node's incoming disabled edges to the cut, and visit any unseen, non-disabled incoming.edges()
-			//for (int i = 0; i < outer->inv_adj[u].size(); i++) {
+			//for (int i = 0; i < outer->nIncomingEdges(u); i++) {
 			for(int i = 0;i<g_over.nIncoming(u);i++){
-				//int v = outer->inv_adj[u][i].v;
-				//int from = outer->inv_adj[u][i].from;
-				//assert(outer->inv_adj[u][i].to == u);
+				//int v = outer->getIncomingEdge(u, i).v;
+				//int from = outer->getIncomingEdge(u, i).from;
+				//assert(outer->getIncomingEdge(u, i).to == u);
 				int from =  g_over.incoming(u,i).node;
 				int edge_num =  g_over.incoming(u,i).id;
 
@@ -973,7 +1014,7 @@ void DistanceDetector<Weight>::buildDistanceGTReason(int to, Weight & min_distan
 				}
 				assert(from != u);
 				
-				if (has_weighted_shortest_paths_overapprox && reaches) {
+				if (has_weighted_shortest_paths_overapprox && reaches && overapprox_weighted_distance_detector->connected(u)) {
 					//This is an optional optimization: if we know that even with all possible edges enabled, the shortest path to from + 1 is >= than the current distance to this node, enabling this edge cannot decrease the shortest path,
 					//and so we don't need to consider this edge
 					Weight current_dist = overapprox_weighted_distance_detector->distance(u);
@@ -1095,8 +1136,16 @@ void DistanceDetector<Weight>::updateShortestPaths(bool unweighted) {
 		} else {
 			has_weighted_shortest_paths_overapprox = true;
 			over_approx_shortest_paths.growTo(g_under.nodes());
-			for (int i = 0; i < g_over.nodes(); i++) {
-				over_approx_shortest_paths[i] = overapprox_weighted_distance_detector->distance(i);
+			if (alt_landmarks) {
+				//the goal-directed detector only computes exact distances to its targets
+				Dijkstra<Weight> d(source, g_over);
+				for (int i = 0; i < g_over.nodes(); i++) {
+					over_approx_shortest_paths[i] = d.distance(i);
+				}
+			} else {
+				for (int i = 0; i < g_over.nodes(); i++) {
+					over_approx_shortest_paths[i] = overapprox_weighted_distance_detector->distance(i);
+				}
 			}
 		}
 	}
@@ -1256,6 +1305,10 @@ bool DistanceDetector<Weight>::propagate(vec<Lit> & conflict) {
 	if (opt_rnd_shuffle && weighted_dist_bv_lits.size()) {
 		randomShuffle(rnd_seed, weighted_dist_bv_lits);
 	}
+	if (alt_landmarks && outer->decisionLevel() == 0) {
+		//g_over only loses edges (and its edge weights only increase) above level 0, so these remain lower bounds until we return here
+		alt_landmarks->update();
+	}
 	if (weighted_dist_lits.size() || weighted_dist_bv_lits.size()) {
 		updateShortestPaths(false);						//only needed for the shortest path theory
 	}
@@ -28,6 +28,7 @@
 #include "dgl/Reach.h"
 #include "dgl/Distance.h"
 #include "dgl/Dijkstra.h"
+#include "dgl/ALTDijkstra.h"
 #include "dgl/BFS.h"
 #include "dgl/MaxFlow.h"
 #include "core/SolverTypes.h"
@@ -66,6 +67,8 @@ public:
 	Distance<Weight> * overapprox_weighted_distance_detector = nullptr;
 	Distance<Weight> * underapprox_weighted_path_detector = nullptr;
 	Reach * underapprox_path_detector = nullptr;
+	//Landmark lower bounds for the goal-directed weighted detectors, while this source has few enough distinct targets (else null).
+	ALTLandmarks<Weight> * alt_landmarks = nullptr;
 
 	//vec<Lit>  reach_lits;
 	Var first_reach_var;
@@ -257,6 +260,8 @@ public:
 	void addUnweightedShortestPathLit(int from, int to, Var reach_var, int within_steps = -1);
 	void addWeightedShortestPathLit(int from, int to, Var reach_var, Weight within_distance, bool strictComparison);
 	void addWeightedShortestPathBVLit(int from, int to, Var reach_var, const BitVector<Weight> & bv, bool strictComparison);
+	void buildWeightedDetectors();
+	void addWeightedTarget(int to);
 
 	DistanceDetector(int _detectorID, GraphTheorySolver<Weight> * _outer,
 			DynamicGraph<Weight>  &_g, DynamicGraph<Weight>  &_antig, int _source, double seed = 1);//:Detector(_detectorID),outer(_outer),within(-1),source(_source),rnd_seed(seed),positive_reach_detector(NULL),negative_reach_detector(NULL),positive_path_detector(NULL),positiveReachStatus(NULL),negativeReachStatus(NULL){}
@@ -290,6 +295,8 @@ public:
 		if (overapprox_weighted_distance_detector)
 			delete overapprox_weighted_distance_detector;
 
+		if (alt_landmarks)
+			delete alt_landmarks;
 
 
 		if (rnd_path)
@@ -515,8 +515,6 @@ public:
 	
 	//Just a list of the edges
 	vec<Edge> edge_list;
-	vec<vec<Edge> > undirected_adj;
-	vec<vec<Edge> > inv_adj;
 
 	//vector of the weights for each edge
 	std::vector<Weight> edge_weights;
@@ -546,6 +544,10 @@ public:
 */
 
 	bool requiresPropagation = true;
+	//Edge assignments that have been enqueued, but not yet applied to the graphs (see applyPendingEdges()).
+	//edge_pending is 1 for each such edge, or 2 if it was assigned at level 0.
+	vec<int> pending_edges;
+	vec<char> edge_pending;
 	//int n_decisions = 0;
 	//vec<int> var_decision_pos;
 
@@ -574,7 +576,6 @@ public:
 	double reachtime = 0;
 	double unreachtime = 0;
 	double pathtime = 0;
-	double propagationtime = 0;
 	long propagations =-1;
 	long stats_propagations = 0;
 	long stats_num_conflicts = 0;
@@ -585,9 +586,8 @@ public:
 	double reachupdatetime = 0;
 	double unreachupdatetime = 0;
 	double stats_initial_propagation_time = 0;
-	double stats_decision_time = 0;
-	double stats_reason_initial_time = 0;
-	double stats_reason_time = 0;
+	ProfileCounter decision_profile;
+	ProfileCounter reason_profile;
 	long num_learnt_paths = 0;
 	long learnt_path_clause_length = 0;
 	long num_learnt_cuts = 0;
@@ -596,6 +596,8 @@ public:
 	long stats_mc_calls = 0;
 	long stats_propagations_skipped = 0;
 	long stats_lazy_decisions = 0;
+	long stats_edges_batched = 0;
+	long stats_edges_cancelled = 0;
 	vec<Lit> reach_cut;
 
 	struct CutStatus {
@@ -656,6 +658,11 @@ public:
 			cutGraph.outfile = fopen(t.c_str(), "w");
 		}
 
+		//All of the graphs (except for the cut graph, which has two edges for each edge) have the same nodes and edges.
+		g_over.shareTopology(g_under);
+		g_under_weights_over.shareTopology(g_under);
+		g_over_weights_under.shareTopology(g_under);
+
 		g_under.disable_history_clears=disable_history_clears;
 		g_over.disable_history_clears=disable_history_clears;
 		cutGraph.disable_history_clears=disable_history_clears;
@@ -706,17 +713,28 @@ public:
 		 printf("Min-cut Time: %f (%d calls, %f average, #Cuts: %d, AvgLength %f, total: %d)\n", mctime, stats_mc_calls,(mctime/(stats_mc_calls ? stats_mc_calls:1)),  num_learnt_cuts, (learnt_cut_clause_length /  ((float) num_learnt_cuts+1)),learnt_cut_clause_length);
 		 */
 		printf("%d nodes, %d edges\n", g_under.nodes(), g_under.edges());
+		printf("Memory: %.1f MB (topology %.1f MB, graphs %.1f MB, cut graph %.1f MB, edges and atoms %.1f MB)\n",
+				toMB(memoryUsage()), toMB(g_under.topologyMemoryUsage()), toMB(graphMemoryUsage()),
+				toMB(cutGraph.topologyMemoryUsage() + cutGraph.memoryUsage()), toMB(solverMemoryUsage()));
 		printf("History Clears: over_approx %ld, under_approx %ld, cut_graph %ld\n", g_over.historyclears,
 				g_under.historyclears, cutGraph.historyclears);
-		printf("Skipped History Clears: over_approx %ld, under_approx %ld, cut_graph %ld\n", g_over.skipped_historyclears,
+		printf("History Reclaims: over_approx %ld, under_approx %ld, cut_graph %ld\n", g_over.skipped_historyclears,
 				g_under.skipped_historyclears, cutGraph.skipped_historyclears);
+		printf("History Overflows: over_approx %ld, under_approx %ld, cut_graph %ld\n", g_over.history_overflows,
+				g_under.history_overflows, cutGraph.history_overflows);
+		printf("History Compactions: over_approx %ld, under_approx %ld, cut_graph %ld\n", g_over.history_compactions,
+				g_under.history_compactions, cutGraph.history_compactions);
+		if (opt_batch_edges)
+			printf("Batched edge assignments: %ld (%ld backtracked before being applied)\n", stats_edges_batched,
+					stats_edges_cancelled);
+		double propagationtime = getPropagationProfile().seconds();
 		printf("Propagations: %ld (%f s, avg: %f s, %ld skipped)\n", stats_propagations, propagationtime,
 				(propagationtime) / ((double) stats_propagations + 1), stats_propagations_skipped);
-		printf("Decisions: %ld (%f s, avg: %f s), lazy decisions: %ld\n", stats_decisions, stats_decision_time,
-				(stats_decision_time) / ((double) stats_decisions + 1), stats_lazy_decisions);
+		printf("Decisions: %ld (%f s, avg: %f s), lazy decisions: %ld\n", stats_decisions, decision_profile.seconds(),
+				decision_profile.seconds() / ((double) stats_decisions + 1), stats_lazy_decisions);
 		printf("Conflicts: %ld (lazy conflicts %ld)\n", stats_num_conflicts,stats_num_lazy_conflicts);
-		printf("Reasons: %ld (%f s, avg: %f s)\n", stats_num_reasons, stats_reason_time,
-				(stats_reason_time) / ((double) stats_num_reasons + 1));
+		printf("Reasons: %ld (%f s, avg: %f s)\n", stats_num_reasons, reason_profile.seconds(),
+				reason_profile.seconds() / ((double) stats_num_reasons + 1));
 
 		fflush(stdout);
 
@@ -727,6 +745,57 @@ public:
 		fflush(stdout);
 	}
 	
+	static double toMB(size_t bytes) {
+		return bytes / (1024.0 * 1024.0);
+	}
+
+	//Approximate number of bytes allocated for the enabled edges, weights and histories of the graphs (not including their shared topology)
+	size_t graphMemoryUsage() const {
+		return g_under.memoryUsage() + g_over.memoryUsage() + g_under_weights_over.memoryUsage()
+				+ g_over_weights_under.memoryUsage();
+	}
+
+	//Approximate number of bytes allocated by this theory for its edges, atoms and trail (not including the graphs or detectors)
+	size_t solverMemoryUsage() const {
+		size_t bytes = edge_list.capacity() * sizeof(Edge) + vars.capacity() * sizeof(VarData)
+				+ assigns.capacity() * sizeof(lbool) + trail.capacity() * sizeof(Trail)
+				+ edge_weights.capacity() * sizeof(Weight) + edge_bv_weights.capacity() * sizeof(BitVector<Weight>)
+				+ edge_bitvectors.capacity() * sizeof(int) + marker_map.capacity() * sizeof(MarkerEntry)
+				+ edge_pending.capacity() + pending_edges.capacity() * sizeof(int);
+		bytes += (reach_info.capacity() + connect_info.capacity() + dist_info.capacity()
+				+ weighted_dist_info.capacity()) * sizeof(ReachInfo);
+		return bytes;
+	}
+
+	size_t memoryUsage() const {
+		//the topology of g_under is shared by g_over, g_under_weights_over, and g_over_weights_under
+		return g_under.topologyMemoryUsage() + graphMemoryUsage() + cutGraph.topologyMemoryUsage()
+				+ cutGraph.memoryUsage() + solverMemoryUsage();
+	}
+
+	void writeStatsJSON(std::ostream & out) {
+		out << "{\"index\":" << getTheoryIndex() << ",\"type\":\"graph\"";
+		out << ",\"nodes\":" << g_under.nodes() << ",\"edges\":" << g_under.edges();
+		out << ",\"memory\":{\"total\":" << memoryUsage() << ",\"topology\":" << g_under.topologyMemoryUsage()
+				<< ",\"graphs\":" << graphMemoryUsage() << ",\"cut_graph\":"
+				<< (cutGraph.topologyMemoryUsage() + cutGraph.memoryUsage()) << ",\"solver\":" << solverMemoryUsage() << "}";
+		out << ",\"propagate\":";
+		getPropagationProfile().writeJSON(out);
+		out << ",\"decide\":";
+		decision_profile.writeJSON(out);
+		out << ",\"reason\":";
+		reason_profile.writeJSON(out);
+		out << ",\"decisions\":" << stats_decisions << ",\"conflicts\":" << stats_num_conflicts
+				<< ",\"lazy_conflicts\":" << stats_num_lazy_conflicts;
+		out << ",\"detectors\":[";
+		for (int i = 0; i < detectors.size(); i++) {
+			if (i > 0)
+				out << ",";
+			detectors[i]->writeStatsJSON(out);
+		}
+		out << "]}";
+	}
+
 	void writeTheoryWitness(std::ostream& write_to) {
 		
 		for (Detector * d : detectors) {
@@ -1028,8 +1097,6 @@ public:
 
 	int newNode() {
 		
-		inv_adj.push();
-		undirected_adj.push();
 		reach_info.push();
 		connect_info.push();
 		dist_info.push();
@@ -1049,6 +1116,13 @@ public:
 	int nNodes() {
 		return g_under.nodes();
 	}
+	//The incoming edges of each node, in the same order as g_under.incoming()
+	int nIncomingEdges(int node) {
+		return g_under.nIncoming(node);
+	}
+	Edge & getIncomingEdge(int node, int i) {
+		return edge_list[g_under.incoming(node, i).id];
+	}
 	bool isNode(int n) {
 		return n >= 0 && n < nNodes();
 	}
@@ -1262,7 +1336,9 @@ public:
 				int edge_num = getEdgeID(v); //e.var-min_edge_var;
 				assert(assigns[v]!=l_Undef);
 
-				if (assign==l_True) {
+				if (cancelPendingEdge(edge_num)) {
+					//this assignment was never applied to the graphs
+				} else if (assign==l_True) {
 					g_under.disableEdge(edge_num);
 
 					assert(!cutGraph.edgeEnabled(edge_num * 2));
@@ -1461,7 +1537,8 @@ public:
 	Lit decideTheory() {
 		if (!opt_decide_theories)
 			return lit_Undef;
-		double start = rtime(1);
+		ScopedProfile decide_profile(decision_profile);
+		applyPendingEdges();
 		static int iter = 0;
 		iter++;
 
@@ -1486,7 +1563,6 @@ public:
 				stats_lazy_decisions++;
 				stats_decisions++;
 				//printf("g%d: graph lazy decision %d: %d\n", this->id, iter, dimacs(d));
-				stats_decision_time += rtime(1) - start;
 				return solverLit;
 			}
 		}
@@ -1533,7 +1609,6 @@ public:
 						if(bv_decision!=lit_Undef){
 							stats_decisions++;
 							r->undecide(l);
-							stats_decision_time += rtime(1) - start;
 
 							return bv_decision;
 						}
@@ -1542,13 +1617,11 @@ public:
 
 				stats_decisions++;
 				r->stats_decisions++;
-				stats_decision_time += rtime(1) - start;
 				if(opt_verb>2)
 					printf("g%d: graph decision %d: %d\n", this->getTheoryIndex(), iter, dimacs(l));
 				return toSolver(l);
 			}
 		}
-		stats_decision_time += rtime(1) - start;
 		return lit_Undef;
 	}
 	
@@ -1574,28 +1647,23 @@ public:
 		int pos = CRef_Undef - marker;
 		if(marker_map[pos].forTheory){
 			int d = marker_map[pos].id;
-			//double initial_start = rtime(1);
-			double start = rtime(1);
+			ScopedProfile reason_profile_scope(reason_profile);
 			assert(d < detectors.size());
 			theories[d]->buildReason(p, reason,marker);
 			toSolver(reason);
-			double finish = rtime(1);
-			stats_reason_time += finish - start;
 			stats_num_reasons++;
 		}else{
 		
 			int d = marker_map[pos].id;
-			//double initial_start = rtime(1);
-			double start = rtime(1);
+			ScopedProfile reason_profile_scope(reason_profile);
 			backtrackUntil(p);
+			applyPendingEdges();
 
 			assert(d < detectors.size());
+			ScopedProfile detector_profile(detectors[d]->profile.reason);
 			detectors[d]->buildReason(p, reason, marker);
 			toSolver(reason);
-			double finish = rtime(1);
-			stats_reason_time += finish - start;
 			stats_num_reasons++;
-			//stats_reason_initial_time+=start-initial_start;
 		}
 	}
 	
@@ -1655,6 +1723,8 @@ public:
 		for(int i = 0;i<edge_list.size();i++) {
 			if(edge_list[i].v<0)
 			continue;
+			if(i<edge_pending.size() && edge_pending[i])
+			continue;
 			Edge e = edge_list[i];
 			lbool val = value(e.v);
 
@@ -1784,6 +1854,79 @@ public:
 
 		}
 	}
+	void applyEdgeAssignment(int edge_num, bool enabled, bool constant) {
+		if (enabled) {
+			g_under.enableEdge(edge_num);
+		} else {
+			g_over.disableEdge( edge_num);
+			if (opt_conflict_min_cut) {//can optimize this by also checking if any installed detectors are actually using the cutgraph!
+				assert(cutGraph.edgeEnabled(edge_num * 2 + 1));
+				assert(!cutGraph.edgeEnabled(edge_num * 2));
+				cutGraph.enableEdge( edge_num * 2);
+				cutGraph.disableEdge( edge_num * 2 + 1);
+			}
+		}
+
+		if(constant){
+			assert(g_under.edgeEnabled(edge_num)== g_over.edgeEnabled(edge_num));
+			g_under.makeEdgeAssignmentConstant(edge_num);
+			g_over.makeEdgeAssignmentConstant(edge_num);
+		}
+
+		if(using_neg_weights){
+			if (enabled) {
+				g_under_weights_over.enableEdge(edge_num);
+			} else {
+				g_over_weights_under.disableEdge(edge_num);
+			}
+			if(constant){
+				assert(g_under_weights_over.edgeEnabled(edge_num)== g_over_weights_under.edgeEnabled(edge_num));
+				g_under_weights_over.makeEdgeAssignmentConstant(edge_num);
+				g_over_weights_under.makeEdgeAssignmentConstant(edge_num);
+			}
+		}
+	}
+
+	//Returns true if the edge was assigned, but that assignment has not yet been applied to the graphs (in which case it never will be).
+	inline bool cancelPendingEdge(int edge_num) {
+		if (edge_num < edge_pending.size() && edge_pending[edge_num]) {
+			edge_pending[edge_num] = 0;
+			stats_edges_cancelled++;
+			return true;
+		}
+		return false;
+	}
+
+	//Apply all of the pending edge assignments to the graphs, as a single batch of changes.
+	void applyPendingEdges() {
+		if (pending_edges.size() == 0)
+			return;
+		g_under.beginBatch();
+		g_over.beginBatch();
+		cutGraph.beginBatch();
+		if (using_neg_weights) {
+			g_under_weights_over.beginBatch();
+			g_over_weights_under.beginBatch();
+		}
+		for (int i = 0; i < pending_edges.size(); i++) {
+			int edge_num = pending_edges[i];
+			if (!edge_pending[edge_num])
+				continue;//this assignment was backtracked (or is a duplicate entry)
+			bool constant = edge_pending[edge_num] == 2;
+			edge_pending[edge_num] = 0;
+			assert(value(edge_list[edge_num].v) != l_Undef);
+			applyEdgeAssignment(edge_num, value(edge_list[edge_num].v) == l_True, constant);
+		}
+		pending_edges.clear();
+		g_under.endBatch();
+		g_over.endBatch();
+		cutGraph.endBatch();
+		if (using_neg_weights) {
+			g_under_weights_over.endBatch();
+			g_over_weights_under.endBatch();
+		}
+	}
+
 	void enqueueTheory(Lit l) {
 		Var v = var(l);
 
@@ -1814,7 +1957,9 @@ public:
 			//on_trail=true;
 			if (isEdgeVar(v)) {
 				int edge_num = getEdgeID(v); //e.var-min_edge_var;
-				if (assign) {
+				if (cancelPendingEdge(edge_num)) {
+					//this assignment was never applied to the graphs
+				} else if (assign) {
 					g_under.disableEdge( edge_num);
 					assert(!cutGraph.edgeEnabled(edge_num * 2));
 				} else {
@@ -1875,38 +2020,16 @@ public:
 			//this is an edge assignment
 			int edge_num = getEdgeID(var(l)); //v-min_edge_var;
 			assert(edge_list[edge_num].v == var(l));
-			
-			int from = edge_list[edge_num].from;
-			int to = edge_list[edge_num].to;
-			if (!sign(l)) {
-				g_under.enableEdge(edge_num);
+			if (opt_batch_edges) {
+				//defer updating the graphs until the next propagation (or until they are otherwise needed)
+				if (edge_pending.size() <= edge_num)
+					edge_pending.growTo(edge_num + 1, 0);
+				if (!edge_pending[edge_num])
+					pending_edges.push(edge_num);
+				edge_pending[edge_num] = decisionLevel() == 0 ? 2 : 1;
+				stats_edges_batched++;
 			} else {
-				g_over.disableEdge( edge_num);
-				if (opt_conflict_min_cut) {//can optimize this by also checking if any installed detectors are actually using the cutgraph!
-					assert(cutGraph.edgeEnabled(edge_num * 2 + 1));
-					assert(!cutGraph.edgeEnabled(edge_num * 2));
-					cutGraph.enableEdge( edge_num * 2);
-					cutGraph.disableEdge( edge_num * 2 + 1);
-				}
-			}
-
-			if(decisionLevel()==0){
-				assert(g_under.edgeEnabled(edge_num)== g_over.edgeEnabled(edge_num));
-				g_under.makeEdgeAssignmentConstant(edge_num);
-				g_over.makeEdgeAssignmentConstant(edge_num);
-			}
-
-			if(using_neg_weights){
-				if (!sign(l)) {
-					g_under_weights_over.enableEdge(edge_num);
-				} else {
-					g_over_weights_under.disableEdge(edge_num);
-				}
-				if(decisionLevel()==0){
-					assert(g_under_weights_over.edgeEnabled(edge_num)== g_over_weights_under.edgeEnabled(edge_num));
-					g_under_weights_over.makeEdgeAssignmentConstant(edge_num);
-					g_over_weights_under.makeEdgeAssignmentConstant(edge_num);
-				}
+				applyEdgeAssignment(edge_num, !sign(l), decisionLevel() == 0);
 			}
 		} else {
 			//this is an assignment to a non-edge atom. (eg, a reachability assertion)
@@ -1957,6 +2080,7 @@ public:
 		if (++itp == 584) {
 			int a = 1;
 		}
+		applyPendingEdges();
 		dbg_graphsUpToDate();
 		stats_propagations++;
 
@@ -2008,7 +2132,6 @@ public:
 			}
 		}
 		bool any_change = false;
-		double startproptime = rtime(1);
 		
 		conflict.clear();
 		//Can probably speed this up alot by a) constant propagating reaches that I care about at level 0, and b) Removing all detectors for nodes that appear only in the opposite polarity (or not at all) in the cnf.
@@ -2038,7 +2161,11 @@ public:
 			assert(conflict.size() == 0);
 			Lit l = lit_Undef;
 			bool backtrackOnly = lazy_backtracking_enabled && (opt_lazy_conflicts==3) &&  lazy_trail_head!=var_Undef;
-			bool r = detectors[d]->propagate(conflict,backtrackOnly,l);
+			bool r;
+			{
+				ScopedProfile detector_profile(detectors[d]->profile.propagate);
+				r = detectors[d]->propagate(conflict,backtrackOnly,l);
+			}
 			if(!r && backtrackOnly && conflict.size()==0){
 				backtrackUntil(decisionLevel());
 				stats_num_lazy_conflicts++;
@@ -2158,7 +2285,6 @@ public:
 				}
 				stats_num_conflicts++;
 				toSolver(conflict);
-				propagationtime += rtime(1) - startproptime;
 				return false;
 			}
 		}
@@ -2179,8 +2305,6 @@ public:
 		g_under_weights_over.clearHistory();
 		g_over_weights_under.clearHistory();
 		dbg_graphsUpToDate();
-		double elapsed = rtime(1) - startproptime;
-		propagationtime += elapsed;
 		dbg_sync();
 		dbg_sync_reachability();
 		return true;
@@ -2253,6 +2377,7 @@ public:
 	}
 	
 	bool check_solved() {
+		applyPendingEdges();
 		if (opt_print_graph) {
 			drawFull();
 		}
@@ -2621,9 +2746,6 @@ public:
 			comparisons_gt.growTo(bv.getID()+1);
 			comparisons_leq.growTo(bv.getID()+1);
 			comparisons_geq.growTo(bv.getID()+1);
-			undirected_adj[to].push( { v, outerVar, from, to, index });
-			undirected_adj[from].push( { v, outerVar, to, from, index });
-			inv_adj[to].push( { v, outerVar, from, to, index });
 
 			//num_edges++;
 			edge_list[index].v = v;
@@ -2712,9 +2834,6 @@ public:
 		edge_list.push();
 		Var v = newVar(outerVar, index, true);
 		//bv_needs_update.growTo(bv.getID()+1);
-		undirected_adj[to].push( { v, outerVar, from, to, index });
-		undirected_adj[from].push( { v, outerVar, to, from, index });
-		inv_adj[to].push( { v, outerVar, from, to, index });
 
 		//num_edges++;
 		edge_list[index].v = v;
@@ -2771,10 +2890,6 @@ public:
 		 edge_list.push({-1,-1,-1,-1,-1,1});
 		 assigns.push(l_Undef);
 		 }*/
-		undirected_adj[to].push( { v, outerVar, from, to, index });
-		undirected_adj[from].push( { v, outerVar, to, from, index });
-		inv_adj[to].push( { v, outerVar, from, to, index });
-		
 		//num_edges++;
 		edge_list[index].v = v;
 		edge_list[index].outerVar = outerVar;
@@ -844,8 +844,6 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 		fflush(g_over.outfile);
 	}
 
-	
-	double start_prop_time = rtime(2);
 
 	Weight over_maxflow = -1;
 	Weight under_maxflow = -1;
@@ -853,24 +851,20 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 	bool computed_over=false;
 	
 	if (underapprox_detector && (!opt_detect_pure_theory_lits || unassigned_positives > 0)) {
-		double startdreachtime = rtime(2);
+		ScopedProfile update_profile(profile.under_update);
 		stats_under_updates++;
 		computed_under=true;
 		under_maxflow = underapprox_detector->maxFlow();
 		assert(under_maxflow == underapprox_conflict_detector->maxFlow());
-		double reachUpdateElapsed = rtime(2) - startdreachtime;
-		stats_under_update_time += reachUpdateElapsed;
 	} else
 		stats_skipped_under_updates++;
 	
 	if (overapprox_detector && (!opt_detect_pure_theory_lits || unassigned_negatives > 0)) {
-		double startunreachtime = rtime(2);
+		ScopedProfile update_profile(profile.over_update);
 		stats_over_updates++;
 		computed_over=true;
 		over_maxflow = overapprox_detector->maxFlow();
 		assert(over_maxflow == overapprox_conflict_detector->maxFlow());
-		double unreachUpdateElapsed = rtime(2) - startunreachtime;
-		stats_over_update_time += unreachUpdateElapsed;
 	} else
 		stats_skipped_over_updates++;
 	
@@ -891,7 +885,6 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 					outer->enqueue(l, underprop_marker);
 
 				} else if (outer->value(l) == l_False) {
-					stats_total_prop_time += rtime(2)-start_prop_time;
 					if(backtrackOnly){
 						return false;
 						/*conflictLit = findFirstReasonTooHigh(maxflow);
@@ -913,7 +906,6 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 					outer->enqueue(~l, underprop_marker);
 
 				} else if (outer->value(l) == l_True) {
-					stats_total_prop_time += rtime(2)-start_prop_time;
 					if(backtrackOnly){
 						return false;
 					/*	conflictLit= findFirstReasonTooLow(maxflow);
@@ -944,7 +936,6 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 					outer->enqueue(l, underprop_marker);
 					//should also enqueue that the flow is >= under->flow, and <= over->flow...
 				} else if (outer->value(l) == l_False) {
-					stats_total_prop_time += rtime(2)-start_prop_time;
 					if(backtrackOnly)
 						return false;
 
@@ -962,7 +953,6 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 					outer->enqueue(~l, underprop_marker);
 					//should also enqueue that the flow is >= under->flow, and <= over->flow...
 				} else if (outer->value(l) == l_True) {
-					stats_total_prop_time += rtime(2)-start_prop_time;
 					if(backtrackOnly)
 						return false;
 
@@ -975,7 +965,6 @@ bool MaxflowDetector<Weight>::propagate(vec<Lit> & conflict, bool backtrackOnly,
 			}
 		}
 	}
-	stats_total_prop_time += rtime(2)-start_prop_time;
 	return true;
 }
 template<typename Weight>
@@ -1104,7 +1093,7 @@ void MaxflowDetector<Weight>::collectDisabledEdges() {
 	if (opt_conflict_min_cut_maxflow) {
 		buildLearnGraph();
 		
-		if (learngraph_history_clears != g_over.historyclears || g_over.changed()) {
+		if (learngraph_history_clears != g_over.historyclears || !g_over.historyAvailable(learngraph_history_qhead) || g_over.changed()) {
 			//refresh
 			overapprox_conflict_detector->update();
 			for (int edgeid = 0; edgeid < g_over.edges(); edgeid++) {
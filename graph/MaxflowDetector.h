@@ -67,7 +67,6 @@ public:
 	int alg_id=-1;
 
 	long stats_decision_calculations = 0;
-	double stats_total_prop_time=0;
 	double stats_flow_calc_time = 0;
 	double stats_flow_recalc_time = 0;
 	double stats_redecide_time = 0;
@@ -153,7 +152,7 @@ public:
 	void suggestDecision(Lit l);
 	void printStats() {
 		Detector::printStats();
-		printf("\tTotal Detector Propagation Time: %fs\n",stats_total_prop_time);
+		printf("\tTotal Detector Propagation Time: %fs\n",profile.propagate.seconds());
 		if (mincutalg == MinCutAlg::ALG_KOHLI_TORR) {
 			KohliTorr<Weight> * kt = (KohliTorr<Weight> *) overapprox_detector;
 			printf(
@@ -258,7 +258,8 @@ void ReachDetector<Weight>::buildSATConstraints(bool onlyUnderApprox, int within
 			for (int j = 0; j < g_under.nodes(); j++) {
 				Lit r_cur = reaches[j];
 				
-				for (Edge & e : outer->inv_adj[j]) {
+				for (int k = 0; k < outer->nIncomingEdges(j); k++) {
+					Edge e = outer->getIncomingEdge(j, k);
 					//Edge e = outer->edges[j][k];
 					assert(e.to == j);
 					if (outer->value(dist_lits.last()[e.to]) == l_True) {
@@ -692,9 +693,9 @@ void ReachDetector<Weight>::buildNonReachReason(int node, vec<Lit> & conflict, b
 			assert(outer->dbg_notreachable(source, u));
 			//assert(!negative_reach_detector->connected_unsafe(u));
 			//Ok, then add all its incoming disabled edges to the cut, and visit any unseen, non-disabled incoming.edges()
-			for (int i = 0; i < outer->inv_adj[u].size(); i++) {
-				int v = outer->inv_adj[u][i].v;
-				int from = outer->inv_adj[u][i].from;
+			for (int i = 0; i < outer->nIncomingEdges(u); i++) {
+				int v = outer->getIncomingEdge(u, i).v;
+				int from = outer->getIncomingEdge(u, i).from;
 				int edge_num = outer->getEdgeID(v);				    	// v-outer->min_edge_var;
 				if (from == u) {
 					assert(outer->edge_list[edge_num].to == u);
@@ -702,7 +703,7 @@ void ReachDetector<Weight>::buildNonReachReason(int node, vec<Lit> & conflict, b
 					continue;				  //Self loops are allowed, but just make sure nothing got flipped around...
 				}
 				assert(from != u);
-				assert(outer->inv_adj[u][i].to == u);
+				assert(outer->getIncomingEdge(u, i).to == u);
 				//Note: the variable has to not only be assigned false, but assigned false earlier in the trail than the reach variable...
 				
 				if (outer->value(v) == l_False) {
@@ -966,11 +967,11 @@ void ReachDetector<Weight>::buildForcedEdgeReason(int reach_node, int forced_edg
 			assert(seen[u]);
 			assert(!overapprox_reach_detector->connected_unsafe(u));
 			//Ok, then add all its incoming disabled edges to the cut, and visit any unseen, non-disabled incoming.edges()
-			for (int i = 0; i < outer->inv_adj[u].size(); i++) {
-				int v = outer->inv_adj[u][i].v;
-				int from = outer->inv_adj[u][i].from;
+			for (int i = 0; i < outer->nIncomingEdges(u); i++) {
+				int v = outer->getIncomingEdge(u, i).v;
+				int from = outer->getIncomingEdge(u, i).from;
 				assert(from != u);
-				assert(outer->inv_adj[u][i].to == u);
+				assert(outer->getIncomingEdge(u, i).to == u);
 				//Note: the variable has to not only be assigned false, but assigned false earlier in the trail than the reach variable...
 				int edge_num = outer->getEdgeID(v);						// v-outer->min_edge_var;
 						
@@ -1067,12 +1068,9 @@ bool ReachDetector<Weight>::propagate(vec<Lit> & conflict) {
 
 	bool skipped_positive = false;
 	if (underapprox_detector && (!opt_detect_pure_theory_lits || unassigned_positives > 0)) {
-		double startdreachtime = rtime(2);
+		ScopedProfile update_profile(profile.under_update);
 		stats_under_updates++;
 		underapprox_detector->update();
-		double reachUpdateElapsed = rtime(2) - startdreachtime;
-		//outer->reachupdatetime+=reachUpdateElapsed;
-		stats_under_update_time += rtime(2) - startdreachtime;
 	} else {
 		skipped_positive = true;
 		//outer->stats_pure_skipped++;
@@ -1080,12 +1078,9 @@ bool ReachDetector<Weight>::propagate(vec<Lit> & conflict) {
 	}
 	bool skipped_negative = false;
 	if (overapprox_reach_detector && (!opt_detect_pure_theory_lits || unassigned_negatives > 0)) {
-		double startunreachtime = rtime(2);
+		ScopedProfile update_profile(profile.over_update);
 		stats_over_updates++;
 		overapprox_reach_detector->update();
-		double unreachUpdateElapsed = rtime(2) - startunreachtime;
-		//outer->unreachupdatetime+=unreachUpdateElapsed;
-		stats_over_update_time += rtime(2) - startunreachtime;
 	} else {
 		skipped_negative = true;
 		stats_skipped_over_updates++;
@@ -1314,7 +1309,7 @@ template<typename Weight>
 Lit ReachDetector<Weight>::decide() {
 	if (!opt_allow_reach_decisions)
 		return lit_Undef;
-	double startdecidetime = rtime(2);
+	ScopedProfile decide_profile(profile.decide);
 	auto * over_reach = overapprox_reach_detector;
 	auto * under_reach = underapprox_detector;
 	
@@ -1337,7 +1332,6 @@ Lit ReachDetector<Weight>::decide() {
 			Lit l = to_decide.last();
 			to_decide.pop();
 			if (outer->value(l) == l_Undef) {
-				stats_decide_time += rtime(2) - startdecidetime;
 				return l;
 			}
 		}
@@ -1487,7 +1481,6 @@ Lit ReachDetector<Weight>::decide() {
 							Lit l = to_decide.last();
 							to_decide.pop();
 							if (outer->value(l) == l_Undef) {
-								stats_decide_time += rtime(2) - startdecidetime;
 								return l;
 							}
 						}
@@ -1525,7 +1518,6 @@ Lit ReachDetector<Weight>::decide() {
 							Lit l = to_decide.last();
 							to_decide.pop();
 							if (outer->value(l) == l_Undef) {
-								stats_decide_time += rtime(2) - startdecidetime;
 								return l;
 							}
 						}
@@ -1591,7 +1583,6 @@ Lit ReachDetector<Weight>::decide() {
 			assert(outer->edge_list[edgeID_to_assign].edgeID == edgeID_to_assign);
 			Var v = outer->edge_list[edgeID_to_assign].v;
 			if (outer->value(v) == l_Undef) {
-				stats_decide_time += rtime(2) - startdecidetime;
 				return mkLit(v, false);
 			} else {
 				assert(outer->value(v)!=l_True);
@@ -1599,7 +1590,6 @@ Lit ReachDetector<Weight>::decide() {
 		}
 		
 	}
-	stats_decide_time += rtime(2) - startdecidetime;
 	return lit_Undef;
 }
 ;
@@ -22,6 +22,7 @@
 #include "SteinerDetector.h"
 #include "GraphTheory.h"
 #include "dgl/SteinerApprox.h"
+#include "dgl/DreyfusWagner.h"
 #include "dgl/DynamicNodes.h"
 #include <limits>
 #include <set>
@@ -41,10 +42,18 @@ SteinerDetector<Weight>::SteinerDetector(int detectorID, GraphTheorySolver<Weigh
 	negativeStatus = new SteinerDetector<Weight>::SteinerStatus(*this, false);
 	
 	//NOTE: the terminal sets are intentionally swapped, in order to preserve monotonicity
-	underapprox_detector = new SteinerApprox<DynamicNodes, SteinerDetector<Weight>::SteinerStatus, Weight>(g,
-			overTerminalSet, *positiveStatus, 1); //new SpiraPan<SteinerDetector<Weight>::MSTStatus>(_g,*(positiveReachStatus),1);
-	overapprox_detector = new SteinerApprox<DynamicNodes, SteinerDetector<Weight>::SteinerStatus, Weight>(antig,
-			 underTerminalSet, *negativeStatus, -1);
+	if (opt_steiner_exact_terminals > 0) {
+		//exact while few terminals are enabled, falling back on the approximation otherwise
+		underapprox_detector = new DreyfusWagner<DynamicNodes, SteinerDetector<Weight>::SteinerStatus, Weight>(g,
+				overTerminalSet, *positiveStatus, 1, opt_steiner_exact_terminals);
+		overapprox_detector = new DreyfusWagner<DynamicNodes, SteinerDetector<Weight>::SteinerStatus, Weight>(antig,
+				underTerminalSet, *negativeStatus, -1, opt_steiner_exact_terminals);
+	} else {
+		underapprox_detector = new SteinerApprox<DynamicNodes, SteinerDetector<Weight>::SteinerStatus, Weight>(g,
+				overTerminalSet, *positiveStatus, 1); //new SpiraPan<SteinerDetector<Weight>::MSTStatus>(_g,*(positiveReachStatus),1);
+		overapprox_detector = new SteinerApprox<DynamicNodes, SteinerDetector<Weight>::SteinerStatus, Weight>(antig,
+				underTerminalSet, *negativeStatus, -1);
+	}
 	
 	underprop_marker = outer->newReasonMarker(getID());
 	overprop_marker = outer->newReasonMarker(getID());
@@ -399,10 +408,10 @@ bool SteinerDetector<Weight>::checkSatisfied() {
 	
 	assert(underTerminalSet.numEnabled() == overTerminalSet.numEnabled());
 	
-	SteinerApprox<DynamicNodes, typename SteinerTree<Weight>::NullStatus, Weight> positive_checker(g_under,
-			overTerminalSet, SteinerTree<Weight>::nullStatus, 0);
-	SteinerApprox<DynamicNodes, typename SteinerTree<Weight>::NullStatus, Weight> negative_checker(g_over,
-			underTerminalSet, SteinerTree<Weight>::nullStatus, 0);
+	DreyfusWagner<DynamicNodes, typename SteinerTree<Weight>::NullStatus, Weight> positive_checker(g_under,
+			overTerminalSet, SteinerTree<Weight>::nullStatus, 0, opt_steiner_exact_terminals);
+	DreyfusWagner<DynamicNodes, typename SteinerTree<Weight>::NullStatus, Weight> negative_checker(g_over,
+			underTerminalSet, SteinerTree<Weight>::nullStatus, 0, opt_steiner_exact_terminals);
 	positive_checker.update();
 	negative_checker.update();
 	Weight & w = positive_checker.weight();
@@ -147,6 +147,14 @@ public:
 		}
 	}
 	
+	void printStats() {
+		Detector::printStats();
+		if (opt_verb > 0) {
+			underapprox_detector->printStats();
+			overapprox_detector->printStats();
+		}
+	}
+
 	const char* getName() {
 		return "Steiner Detector";
 	}
@@ -43,6 +43,7 @@ public:
 	int history_qhead;
 
 	int last_history_clear;
+	int history_id;
 
 	int source;
 	Weight INF;
@@ -80,6 +81,7 @@ public:
 	WeightedDijkstra(int s, DynamicGraph<GraphWeight> & graph, std::vector<Weight> & weights) :
 			g(graph), weights(weights), last_modification(-1), last_addition(-1), last_deletion(-1), history_qhead(0), last_history_clear(
 					0), source(s), INF(0), q(DistCmp(dist)) {
+		history_id = g.addHistoryConsumer();
 		
 		mod_percentage = 0.2;
 		
@@ -113,16 +115,16 @@ public:
 		}
 		
 		q.clear();
-		if (last_history_clear != g.historyclears) {
-			history_qhead = 0;
+		if (last_history_clear != g.historyclears || !g.historyAvailable(history_qhead)) {
+			history_qhead = g.historyStart();
 			last_history_clear = g.historyclears;
 		}
 		//ok, now check if any of the added edges allow for a decrease in distance.
 		for (int i = history_qhead; i < g.historySize(); i++) {
 			assert(g.getChange(i).addition); //NOTE: Currently, this is glitchy in some circumstances - specifically, ./modsat -rinc=1.05 -rnd-restart  -conflict-shortest-path  -no-conflict-min-cut   -rnd-init -rnd-seed=01231 -rnd-freq=0.01 /home/sam/data/gnf/unit_tests/unit_test_17_reduced.gnf can trigger this assertion!
 			int edgeID = g.getChange(i).id;
-			int u = g.all_edges[edgeID].from;
-			int v = g.all_edges[edgeID].to;
+			int u = g.getEdge(edgeID).from;
+			int v = g.getEdge(edgeID).to;
 			Weight alt = dist[u] + weights[u];
 			if (alt < dist[v]) {
 				
@@ -139,8 +141,8 @@ public:
 				else
 					q.decrease(v);
 			} else if (undirected) {
-				int v = g.all_edges[edgeID].from;
-				int u = g.all_edges[edgeID].to;
+				int v = g.getEdge(edgeID).from;
+				int u = g.getEdge(edgeID).to;
 				Weight alt = dist[u] + weights[u];
 				if (alt < dist[v]) {
 					
@@ -160,6 +162,7 @@ public:
 			}
 		}
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		
 		while (q.size()) {
 			int u = q.removeMin();
@@ -318,6 +321,7 @@ public:
 		last_addition = g.additions;
 		
 		history_qhead = g.historySize();
+		g.updateHistoryConsumer(history_id, history_qhead);
 		last_history_clear = g.historyclears;
 		
 		;
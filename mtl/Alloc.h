@@ -20,46 +20,72 @@
 #ifndef Minisat_Alloc_h
 #define Minisat_Alloc_h
 
+#include <stdint.h>
+#include <string.h>
 #include "mtl/XAlloc.h"
 #include "mtl/Vec.h"
 
+#if defined(__linux__) && !defined(MONOSAT_NO_MMAP_ARENA)
+#include <sys/mman.h>
+#define MONOSAT_MMAP_ARENA
+#endif
+
 namespace Monosat {
 
 //=================================================================================================
 // Simple Region-based memory allocator:
+//
+// References into the region are 32-bit by default, which limits a region to 2^32 elements.
+// Compile with -DMONOSAT_64BIT_CREF to use 64-bit references instead (at the cost of larger watchers and reasons).
+//
+// On Linux, the region reserves (but does not commit) enough virtual memory for its maximum size up front,
+// so that it grows in place rather than being copied, and asks for it to be backed by transparent huge pages.
+// Compile with -DMONOSAT_NO_MMAP_ARENA to use realloc instead, or -DMONOSAT_NO_HUGE_PAGES to skip the huge pages.
+
+#ifdef MONOSAT_64BIT_CREF
+typedef uint64_t RegionRef;
+#ifndef MONOSAT_ARENA_RESERVE_BYTES
+//Virtual memory to reserve for each region when using 64-bit references; the region is moved (once) if it outgrows this.
+#define MONOSAT_ARENA_RESERVE_BYTES (((uint64_t) 1) << 40)
+#endif
+#else
+typedef uint32_t RegionRef;
+#endif
 
 template<class T>
 class RegionAllocator {
-	T* memory;
-	uint32_t sz;
-	uint32_t cap;
-	uint32_t wasted_;
-
-	void capacity(uint32_t min_cap);
-
 public:
 	// TODO: make this a class for better type-checking?
-	typedef uint32_t Ref;
-	enum {
-		Ref_Undef = UINT32_MAX
-	};
+	typedef RegionRef Ref;
+	static const Ref Ref_Undef = ~((Ref) 0);
 	enum {
 		Unit_Size = sizeof(uint32_t)
 	};
+private:
+	T* memory;
+	Ref sz;
+	Ref cap;
+	Ref wasted_;
+	//Number of elements of virtual memory reserved at 'memory', if it was allocated with mmap (else 0)
+	Ref reserved;
+
+	void capacity(Ref min_cap);
+	bool reserve(Ref min_elements);
+	void release();
 
-	explicit RegionAllocator(uint32_t start_cap = 1024 * 1024) :
-			memory(NULL), sz(0), cap(0), wasted_(0) {
+public:
+	explicit RegionAllocator(Ref start_cap = 1024 * 1024) :
+			memory(NULL), sz(0), cap(0), wasted_(0), reserved(0) {
 		capacity(start_cap);
 	}
 	~RegionAllocator() {
-		if (memory != NULL)
-			::free(memory);
+		release();
 	}
 	
-	uint32_t size() const {
+	Ref size() const {
 		return sz;
 	}
-	uint32_t wasted() const {
+	Ref wasted() const {
 		return wasted_;
 	}
 	
@@ -92,31 +118,84 @@ public:
 	}
 	
 	void moveTo(RegionAllocator& to) {
-		if (to.memory != NULL)
-			::free(to.memory);
+		to.release();
 		to.memory = memory;
 		to.sz = sz;
 		to.cap = cap;
 		to.wasted_ = wasted_;
+		to.reserved = reserved;
 		
 		memory = NULL;
-		sz = cap = wasted_ = 0;
+		sz = cap = wasted_ = reserved = 0;
 	}
 	
 };
 
 template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap) {
+const typename RegionAllocator<T>::Ref RegionAllocator<T>::Ref_Undef;
+
+template<class T>
+void RegionAllocator<T>::release() {
+	if (memory != NULL) {
+#ifdef MONOSAT_MMAP_ARENA
+		if (reserved)
+			munmap(memory, sizeof(T) * reserved);
+		else
+#endif
+			::free(memory);
+	}
+	memory = NULL;
+	reserved = 0;
+}
+
+//Reserve virtual memory for at least min_elements (moving the current contents there, if any);
+//returns false if that isn't possible, in which case the region falls back to realloc.
+template<class T>
+bool RegionAllocator<T>::reserve(Ref min_elements) {
+#ifdef MONOSAT_MMAP_ARENA
+	if (memory != NULL && !reserved)
+		return false;
+#ifdef MONOSAT_64BIT_CREF
+	Ref elements = MONOSAT_ARENA_RESERVE_BYTES / sizeof(T);
+	while (elements < min_elements && elements < Ref_Undef / 2)
+		elements *= 2;
+#else
+	//enough for every 32-bit reference
+	Ref elements = Ref_Undef;
+#endif
+	if (elements < min_elements)
+		return false;
+	void * mem = mmap(NULL, sizeof(T) * (size_t) elements, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mem == MAP_FAILED)
+		return false;
+#if defined(MADV_HUGEPAGE) && !defined(MONOSAT_NO_HUGE_PAGES)
+	madvise(mem, sizeof(T) * (size_t) elements, MADV_HUGEPAGE);
+#endif
+	if (memory != NULL) {
+		memcpy(mem, memory, sizeof(T) * sz);
+		munmap(memory, sizeof(T) * reserved);
+	}
+	memory = (T*) mem;
+	reserved = elements;
+	return true;
+#else
+	return false;
+#endif
+}
+
+template<class T>
+void RegionAllocator<T>::capacity(Ref min_cap) {
 	if (cap >= min_cap)
 		return;
 	
-	uint32_t prev_cap = cap;
+	Ref prev_cap = cap;
 	while (cap < min_cap) {
 		// NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
 		// result even by clearing the least significant bit. The resulting sequence of capacities
 		// is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
 		// using 'uint32_t' as indices so that as much as possible of this space can be used.
-		uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+		Ref delta = ((cap >> 1) + (cap >> 3) + 2) & ~((Ref) 1);
 		cap += delta;
 		
 		if (cap <= prev_cap)
@@ -125,6 +204,10 @@ void RegionAllocator<T>::capacity(uint32_t min_cap) {
 	// printf(" .. (%p) cap = %u\n", this, cap);
 	
 	assert(cap > 0);
+	//if the region is backed by reserved virtual memory, then growing it (usually) doesn't move or copy anything;
+	//the new pages are only committed as they are touched.
+	if (cap <= reserved || reserve(cap))
+		return;
 	memory = (T*) xrealloc(memory, sizeof(T) * cap);
 }
 
@@ -134,7 +217,7 @@ typename RegionAllocator<T>::Ref RegionAllocator<T>::alloc(int size) {
 	assert(size > 0);
 	capacity(sz + size);
 	
-	uint32_t prev_sz = sz;
+	Ref prev_sz = sz;
 	sz += size;
 	
 	// Handle overflow:
@@ -0,0 +1,96 @@
+/************************************************************************************[BoundedQueue.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef Minisat_BoundedQueue_h
+#define Minisat_BoundedQueue_h
+
+#include "mtl/Vec.h"
+#include <cassert>
+#include <cstdint>
+
+namespace Monosat {
+
+//=================================================================================================
+// A fixed size window over the most recently pushed values, maintaining their moving average.
+// Once full, each push discards the oldest value in the window.
+
+template<class T>
+class BoundedQueue {
+	vec<T> buf;
+	int first = 0;
+	int n = 0;
+	int64_t sum = 0;
+
+public:
+	BoundedQueue() {
+	}
+	explicit BoundedQueue(int maxSize) {
+		init(maxSize);
+	}
+
+	void init(int maxSize) {
+		assert(maxSize > 0);
+		buf.clear();
+		buf.growTo(maxSize);
+		clear();
+	}
+
+	void push(T x) {
+		assert(buf.size() > 0);
+		if (n == buf.size()) {
+			sum -= buf[first];
+			buf[first] = x;
+			if (++first == buf.size())
+				first = 0;
+		} else {
+			int i = first + n;
+			if (i >= buf.size())
+				i -= buf.size();
+			buf[i] = x;
+			n++;
+		}
+		sum += x;
+	}
+
+	void clear() {
+		first = 0;
+		n = 0;
+		sum = 0;
+	}
+
+	int size() const {
+		return n;
+	}
+	int maxSize() const {
+		return buf.size();
+	}
+	bool full() const {
+		return n > 0 && n == buf.size();
+	}
+	double avg() const {
+		return n ? (double) sum / (double) n : 0;
+	}
+};
+
+//=================================================================================================
+}
+
+#endif
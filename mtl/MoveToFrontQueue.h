@@ -0,0 +1,193 @@
+/*******************************************************************************[MoveToFrontQueue.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef Minisat_MoveToFrontQueue_h
+#define Minisat_MoveToFrontQueue_h
+
+#include "mtl/Vec.h"
+#include <cassert>
+#include <cstdint>
+
+namespace Monosat {
+
+//=================================================================================================
+// A 'variable move-to-front' queue (VMTF, as in Biere and Froehlich's "Evaluating CDCL Variable Scoring Schemes"),
+// over the integer keys 0..n-1.
+//
+// Keys are kept in doubly linked lists, ordered by the time they were last moved to the front. The front of a list
+// is its most recently moved key. Each list has a search cursor; every key in front of the cursor must be skipped
+// (eg, is assigned), so finding the next key resumes from the cursor, and callers must 'touch()' keys that may
+// no longer be skipped. Moving a key to the front, inserting, removing and touching keys are all constant time.
+//
+// Keys also have an integer priority, as in the solver's lexicographic decision priorities: there is a separate list
+// for each priority, and keys of higher priority always come first. (There are normally only a handful of distinct
+// priorities.)
+
+class MoveToFrontQueue {
+	struct Link {
+		int prev = -1;
+		int next = -1;
+		int list = -1; //the index of the list this key is in, or -1 if it is not in the queue
+		uint64_t stamp = 0;
+	};
+	struct List {
+		int priority;
+		int first = -1; //least recently moved key
+		int last = -1; //most recently moved key
+		int search = -1; //every key after 'search' (towards 'last') is skipped; -1 if every key is skipped
+		List(int priority) :
+				priority(priority) {
+		}
+	};
+	vec<Link> links;
+	vec<List> lists; //sorted by decreasing priority
+	uint64_t stamp_counter = 0;
+
+	int getList(int priority) {
+		int i = 0;
+		while (i < lists.size() && lists[i].priority > priority)
+			i++;
+		if (i < lists.size() && lists[i].priority == priority)
+			return i;
+		//insert a new list for this priority, at position i
+		lists.push(List(priority));
+		for (int j = lists.size() - 1; j > i; j--)
+			lists[j] = lists[j - 1];
+		lists[i] = List(priority);
+		for (Link & l : links)
+			if (l.list >= i)
+				l.list++;
+		return i;
+	}
+
+	void unlink(int k) {
+		Link & l = links[k];
+		List & list = lists[l.list];
+		if (list.search == k)
+			list.search = l.prev;
+		if (l.prev >= 0)
+			links[l.prev].next = l.next;
+		else
+			list.first = l.next;
+		if (l.next >= 0)
+			links[l.next].prev = l.prev;
+		else
+			list.last = l.prev;
+		l.prev = -1;
+		l.next = -1;
+	}
+
+	void linkLast(int k, int listIndex) {
+		Link & l = links[k];
+		List & list = lists[listIndex];
+		l.list = listIndex;
+		l.prev = list.last;
+		l.next = -1;
+		l.stamp = ++stamp_counter;
+		if (list.last >= 0)
+			links[list.last].next = k;
+		else
+			list.first = k;
+		list.last = k;
+	}
+
+public:
+	bool inQueue(int k) const {
+		return k < links.size() && links[k].list >= 0;
+	}
+
+	//The time that 'k' was last moved to the front (larger is more recent).
+	uint64_t stamp(int k) const {
+		return links[k].stamp;
+	}
+
+	int priority(int k) const {
+		assert(inQueue(k));
+		return lists[links[k].list].priority;
+	}
+
+	//Insert 'k' at the front of the list for 'priority'. The key is not considered for 'next()' until it is touched.
+	void insert(int k, int priority) {
+		assert(!inQueue(k));
+		if (k >= links.size())
+			links.growTo(k + 1);
+		linkLast(k, getList(priority));
+	}
+
+	void remove(int k) {
+		assert(inQueue(k));
+		unlink(k);
+		links[k].list = -1;
+	}
+
+	void moveToFront(int k) {
+		assert(inQueue(k));
+		int list = links[k].list;
+		if (lists[list].last == k) {
+			links[k].stamp = ++stamp_counter;
+			return;
+		}
+		unlink(k);
+		linkLast(k, list);
+	}
+
+	void setPriority(int k, int priority) {
+		assert(inQueue(k));
+		if (lists[links[k].list].priority != priority) {
+			remove(k);
+			insert(k, priority);
+		}
+	}
+
+	//Notify the queue that 'k' may no longer be skipped (eg, it has been unassigned).
+	void touch(int k) {
+		assert(inQueue(k));
+		List & list = lists[links[k].list];
+		if (list.search < 0 || links[k].stamp > links[list.search].stamp)
+			list.search = k;
+	}
+
+	//Return the most recently moved key of the highest priority that is not skipped, or -1 if every key is skipped.
+	//Skipped keys are passed over by later calls, until they are touched.
+	template<class Skip>
+	int next(const Skip & skip) {
+		for (List & list : lists) {
+			int k = list.search;
+			while (k >= 0 && skip(k))
+				k = links[k].prev;
+			list.search = k;
+			if (k >= 0)
+				return k;
+		}
+		return -1;
+	}
+
+	void clear(bool dealloc = false) {
+		links.clear(dealloc);
+		lists.clear(dealloc);
+		stamp_counter = 0;
+	}
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,140 @@
+/****************************************************************************************[Solver.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef WATCHED_PB_PARSER_H_
+#define WATCHED_PB_PARSER_H_
+
+#include <stdio.h>
+
+#include "utils/ParseUtils.h"
+#include "core/SolverTypes.h"
+#include "pb/WatchedPbTheory.h"
+#include "core/Config.h"
+#include "core/Dimacs.h"
+#include <cstdint>
+namespace Monosat {
+
+//=================================================================================================
+// Pseudo-Boolean Constraint Parser:
+//
+//pb <size> lit1 lit2 ... [0 | <size> weight1 weight2 ...] 'op' total
+//where op is one of '<','<=','=','>=','>'.
+//All pb constraints are handled by a single WatchedPbTheory, which is created on demand.
+template<class B, class Solver>
+class WatchedPbParser: public Parser<B, Solver> {
+	using Parser<B, Solver>::mapVar;
+
+	WatchedPbTheory * theory = nullptr;
+	vec<Lit> lits;
+	vec<int64_t> weights;
+
+public:
+	WatchedPbParser(WatchedPbTheory * theory = nullptr) :
+			Parser<B, Solver>("Pseudo-Boolean"), theory(theory) {
+
+	}
+	WatchedPbTheory * getTheory() const {
+		return theory;
+	}
+	bool parseLine(B& in, Solver& S) {
+
+		skipWhitespace(in);
+		if (*in == EOF)
+			return false;
+		if (match(in, "pb") && (*in == ' ' || *in == '\t')) {
+			//(also prevents matching 'pb_lt' lines, which are handled by the graph parser)
+			if (opt_ignore_theories) {
+				skipLine(in);
+				return true;
+			}
+			lits.clear();
+			weights.clear();
+			int size = parseInt(in);
+			if (size <= 0) {
+				parse_errorf("PARSE ERROR! Empty PB constraint\n");
+			}
+			for (int i = 0; i < size; i++) {
+				int parsed_lit = parseInt(in);
+				if (parsed_lit == 0)
+					parse_errorf("PARSE ERROR! Expected %d literals in PB constraint\n", size);
+				int v = abs(parsed_lit) - 1;
+				v = mapVar(S, v);
+				lits.push((parsed_lit > 0) ? mkLit(v) : ~mkLit(v));
+			}
+			int wsize = parseInt(in);
+			if (wsize != 0 && wsize != size) {
+				parse_errorf(
+						"PARSE ERROR! Number of weights must either be the same as the size of the constraint, or 0.\n");
+			}
+			for (int i = 0; i < wsize; i++) {
+				weights.push(parseLong(in));
+			}
+			if (wsize == 0) {
+				for (int i = 0; i < size; i++)
+					weights.push(1);
+			}
+			skipWhitespace(in);
+			WatchedPbTheory::PbType op = WatchedPbTheory::PbType::EQ;
+			if (*in == '<') {
+				++in;
+				if (*in == '=') {
+					++in;
+					op = WatchedPbTheory::PbType::LE;
+				} else {
+					op = WatchedPbTheory::PbType::LT;
+				}
+			} else if (*in == '>') {
+				++in;
+				if (*in == '=') {
+					++in;
+					op = WatchedPbTheory::PbType::GE;
+				} else {
+					op = WatchedPbTheory::PbType::GT;
+				}
+			} else if (*in == '=') {
+				++in;
+				if (*in == '=')
+					++in;
+				op = WatchedPbTheory::PbType::EQ;
+			} else {
+				parse_errorf("PARSE ERROR! Unexpected char: %c\n", *in);
+			}
+			int64_t total = parseLong(in);
+			if (!theory)
+				theory = new WatchedPbTheory(&S);
+			theory->addConstraint(lits, weights, total, op);
+			return true;
+		}
+
+		return false;
+	}
+
+	void implementConstraints(Solver & S) {
+
+	}
+
+};
+
+//=================================================================================================
+}
+;
+
+#endif /* WATCHED_PB_PARSER_H_ */
@@ -0,0 +1,460 @@
+/****************************************************************************************[Solver.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2016, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef WATCHEDPBTHEORY_H_
+#define WATCHEDPBTHEORY_H_
+
+#include "mtl/Vec.h"
+#include "mtl/Sort.h"
+#include "core/SolverTypes.h"
+#include "core/Theory.h"
+#include "core/Solver.h"
+#include "core/Config.h"
+#include <cstdint>
+
+namespace Monosat {
+
+//Pseudo-Boolean constraint theory, using watched-sum propagation.
+//Unlike PbTheory, a single instance of this theory handles all of the pb constraints in the solver.
+//Each constraint is normalized into the form  w_1*l_1 + w_2*l_2 + ... + w_n*l_n >= k, with 0 < w_i <= k,
+//and only enough literals are watched to guarantee that the sum of the non-false watched weights is at least k + max(w_i).
+//When that can no longer be maintained, every unassigned literal whose weight exceeds the remaining slack is implied.
+class WatchedPbTheory: public Theory {
+public:
+	enum class PbType {
+		LT, LE, EQ, GE, GT
+	};
+private:
+	Solver * S;
+	int theory_index = -1;
+	CRef reason_marker = CRef_Undef;
+
+	struct Term {
+		Lit l;
+		bool watched;
+		int64_t weight;
+	};
+	struct PbConstraint {
+		vec<Term> terms; //sorted by decreasing weight
+		int64_t k = 0;
+		int64_t total = 0; //sum of all weights
+		int64_t slack = 0; //sum of the weights of the watched, non-false terms, minus k
+		int next_watch = 0; //position to resume searching for new watches from
+	};
+	struct Watch {
+		int constraintID;
+		int termIndex;
+	};
+
+	vec<PbConstraint> constraints;
+	//watches[toInt(l)] lists the terms that are falsified when l is assigned true.
+	vec<vec<Watch>> watches;
+
+	//The theory's own view of the trail; slack is only updated for literals before qhead.
+	vec<Lit> trail;
+	vec<int> trail_lim;
+	int qhead = 0;
+	vec<int> trail_pos; //position of each assigned var in the trail, or -1
+	//For each literal implied by this theory: the constraint that implied it, and the last trail position involved
+	vec<int> reason_constraint;
+	vec<int> reason_bound;
+
+	//If a var is already attached to another theory, it is replaced by an equivalent var owned by this theory
+	vec<Var> replacement;
+
+	vec<Term> tmp_terms;
+
+public:
+	double propagationtime = 0;
+	long stats_propagations = 0;
+	long stats_implied_lits = 0;
+	long stats_watch_replacements = 0;
+	long stats_reasons = 0;
+	long stats_conflicts = 0;
+	long stats_constraints_as_clauses = 0;
+
+	WatchedPbTheory(Solver * S) :
+			S(S) {
+		S->addTheory(this);
+		reason_marker = S->newReasonMarker(this);
+	}
+	~WatchedPbTheory() {
+	}
+
+	inline int getTheoryIndex() {
+		return theory_index;
+	}
+	inline void setTheoryIndex(int id) {
+		theory_index = id;
+	}
+	inline int decisionLevel() {
+		return S->decisionLevel();
+	}
+	int nConstraints() const {
+		return constraints.size();
+	}
+	void newDecisionLevel() {
+		trail_lim.push(trail.size());
+	}
+
+	//Add the constraint sum(weights[i]*lits[i]) op rhs. Must be called at decision level 0.
+	//Weights may be negative or zero; literals may repeat.
+	void addConstraint(const vec<Lit> & lits, const vec<int64_t> & weights, int64_t rhs, PbType op) {
+		assert(lits.size() == weights.size());
+		S->cancelUntil(0);
+		if (op == PbType::EQ) {
+			addConstraint(lits, weights, rhs, PbType::GE);
+			addConstraint(lits, weights, rhs, PbType::LE);
+			return;
+		}
+		//convert to the form sum >= k
+		bool negate = (op == PbType::LT || op == PbType::LE);
+		int64_t k = rhs;
+		if (op == PbType::GT)
+			k = rhs + 1;
+		else if (op == PbType::LT)
+			k = -(rhs - 1);
+		else if (op == PbType::LE)
+			k = -rhs;
+		tmp_terms.clear();
+		for (int i = 0; i < lits.size(); i++) {
+			int64_t w = negate ? -weights[i] : weights[i];
+			Lit l = lits[i];
+			if (w == 0)
+				continue;
+			if (w < 0) {
+				//w*l == w - w*~l
+				k -= w;
+				w = -w;
+				l = ~l;
+			}
+			tmp_terms.push( { l, false, w });
+		}
+		addNormalized(tmp_terms, k);
+	}
+
+private:
+
+	//Merge repeated vars, remove level 0 assignments, and attach the constraint (or replace it by clauses, if it is trivial)
+	void addNormalized(vec<Term> & terms, int64_t k) {
+		while (true) {
+			//merge duplicate and opposite literals
+			sort(terms, TermVarLt());
+			int i, j = 0;
+			for (i = 0; i < terms.size(); i++) {
+				if (j > 0 && var(terms[j - 1].l) == var(terms[i].l)) {
+					Term & prev = terms[j - 1];
+					if (prev.l == terms[i].l) {
+						prev.weight += terms[i].weight;
+					} else {
+						//w1*x + w2*~x == min(w1,w2) + |w1-w2|*(larger side)
+						int64_t m = std::min(prev.weight, terms[i].weight);
+						k -= m;
+						if (terms[i].weight > prev.weight)
+							prev.l = terms[i].l;
+						prev.weight = prev.weight + terms[i].weight - 2 * m;
+						if (prev.weight == 0)
+							j--;
+					}
+				} else {
+					terms[j++] = terms[i];
+				}
+			}
+			terms.shrink(i - j);
+			//remove level 0 assignments
+			for (i = j = 0; i < terms.size(); i++) {
+				lbool val = S->value(terms[i].l);
+				if (val == l_True) {
+					k -= terms[i].weight;
+				} else if (val == l_Undef) {
+					terms[j++] = terms[i];
+				}
+			}
+			terms.shrink(i - j);
+			if (k <= 0)
+				return; //trivially satisfied
+			int64_t total = 0;
+			for (Term & t : terms) {
+				if (t.weight > k)
+					t.weight = k; //saturate
+				total += t.weight;
+			}
+			if (total < k) {
+				S->addEmptyClause();
+				return;
+			}
+			//any literal whose weight exceeds total-k is implied at level 0
+			bool any_units = false;
+			for (Term & t : terms) {
+				if (t.weight > total - k) {
+					S->addClause(t.l);
+					any_units = true;
+				}
+			}
+			if (!any_units)
+				break;
+			if (!S->okay())
+				return;
+		}
+
+		sort(terms, TermWeightGt());
+		if (terms.last().weight >= k) {
+			//every literal is sufficient on its own, so this is just a clause
+			stats_constraints_as_clauses++;
+			vec<Lit> clause;
+			for (Term & t : terms)
+				clause.push(t.l);
+			S->addClause(clause);
+			return;
+		}
+
+		int constraintID = constraints.size();
+		constraints.push();
+		PbConstraint & c = constraints.last();
+		c.k = k;
+		c.total = 0;
+		for (Term & t : terms) {
+			c.terms.push( { toTheory(t.l), false, t.weight });
+			c.total += t.weight;
+		}
+		//watch the heaviest terms until the sum of the watched weights is at least k + max weight
+		int64_t wmax = c.terms[0].weight;
+		c.slack = -c.k;
+		for (int i = 0; i < c.terms.size() && c.slack < wmax; i++) {
+			watch(constraintID, i);
+			c.next_watch = (i + 1) % c.terms.size();
+		}
+		assert(c.slack >= wmax);
+	}
+
+	struct TermVarLt {
+		bool operator ()(const Term & a, const Term & b) const {
+			return var(a.l) < var(b.l) || (var(a.l) == var(b.l) && a.l < b.l);
+		}
+	};
+	struct TermWeightGt {
+		bool operator ()(const Term & a, const Term & b) const {
+			return a.weight > b.weight;
+		}
+	};
+
+	//Map a solver literal into the literal this theory uses for it (which is also a solver literal).
+	Lit toTheory(Lit l) {
+		Var v = var(l);
+		replacement.growTo(v + 1, var_Undef);
+		if (replacement[v] == var_Undef) {
+			Var r = v;
+			if (S->hasTheory(v)) {
+				//introduce a new replacement variable
+				r = S->newVar();
+				S->addClause(~mkLit(v), mkLit(r));
+				S->addClause(mkLit(v), ~mkLit(r));
+			}
+			replacement[v] = r;
+			S->newTheoryVar(r, getTheoryIndex(), r); //using same variable indices in the theory as out of the theory
+			trail_pos.growTo(r + 1, -1);
+			reason_constraint.growTo(r + 1, -1);
+			reason_bound.growTo(r + 1, -1);
+			watches.growTo(2 * (r + 1));
+		}
+		return mkLit(replacement[v], sign(l));
+	}
+
+	//A term can be watched unless it has been falsified by a literal that this theory has already processed
+	//(terms that are false but not yet processed will still have their weight removed from the slack, later).
+	inline bool canWatch(const Term & t) {
+		return !t.watched && !(S->value(t.l) == l_False && trail_pos[var(t.l)] >= 0 && trail_pos[var(t.l)] < qhead);
+	}
+
+	inline void watch(int constraintID, int termIndex) {
+		PbConstraint & c = constraints[constraintID];
+		Term & t = c.terms[termIndex];
+		assert(canWatch(t));
+		t.watched = true;
+		c.slack += t.weight;
+		watches[toInt(~t.l)].push( { constraintID, termIndex });
+	}
+
+	//The literals of c that were falsified at or before trail position 'bound', heaviest first, until they
+	//are sufficient to explain that the remaining terms (excluding 'excluded_weight') cannot reach k.
+	void explain(PbConstraint & c, int bound, int64_t excluded_weight, vec<Lit> & out) {
+		int64_t needed = c.total - excluded_weight - c.k; //must remove strictly more than this much weight
+		int64_t removed = 0;
+		for (int i = 0; i < c.terms.size() && removed <= needed; i++) {
+			Lit l = c.terms[i].l;
+			if (S->value(l) == l_False && trail_pos[var(l)] >= 0 && trail_pos[var(l)] <= bound) {
+				out.push(l);
+				removed += c.terms[i].weight;
+			}
+		}
+		assert(removed > needed);
+	}
+
+public:
+
+	inline void backtrackUntil(int level) {
+		if (trail_lim.size() > level) {
+			int stop = trail_lim[level];
+			for (int i = trail.size() - 1; i >= stop; i--) {
+				Lit l = trail[i];
+				if (i < qhead) {
+					//restore the slack of each term that was falsified by this assignment (and is still watched)
+					for (Watch & w : watches[toInt(l)]) {
+						PbConstraint & c = constraints[w.constraintID];
+						c.slack += c.terms[w.termIndex].weight;
+					}
+				}
+				trail_pos[var(l)] = -1;
+			}
+			trail.shrink(trail.size() - stop);
+			trail_lim.shrink(trail_lim.size() - level);
+			if (qhead > stop)
+				qhead = stop;
+		}
+	}
+
+	void enqueueTheory(Lit l) {
+		if (trail_pos[var(l)] >= 0)
+			return; //already enqueued (eg, during the solver's initial propagation)
+		int lev = S->level(var(l));
+		while (trail_lim.size() < lev)
+			newDecisionLevel();
+		trail_pos[var(l)] = trail.size();
+		trail.push(l);
+		S->needsPropagation(getTheoryIndex());
+	}
+
+	bool propagateTheory(vec<Lit> & conflict) {
+		if (qhead == trail.size())
+			return true;
+		stats_propagations++;
+		double startproptime = rtime(2);
+		bool has_conflict = false;
+		while (qhead < trail.size() && !has_conflict) {
+			int pos = qhead++;
+			Lit p = trail[pos];
+			vec<Watch> & ws = watches[toInt(p)];
+			int i, j;
+			for (i = j = 0; i < ws.size(); i++) {
+				Watch w = ws[i];
+				PbConstraint & c = constraints[w.constraintID];
+				int64_t weight = c.terms[w.termIndex].weight;
+				c.slack -= weight;
+				if (has_conflict) {
+					//still need to account for the rest of the watches, so that backtracking restores the slack correctly
+					ws[j++] = w;
+					continue;
+				}
+				int64_t wmax = c.terms[0].weight;
+				//look for replacement watches
+				if (c.slack < wmax) {
+					int n = c.terms.size();
+					for (int checked = 0; checked < n && c.slack < wmax; checked++) {
+						int t = c.next_watch;
+						c.next_watch = (c.next_watch + 1 == n) ? 0 : c.next_watch + 1;
+						if (canWatch(c.terms[t])) {
+							watch(w.constraintID, t);
+							stats_watch_replacements++;
+						}
+					}
+				}
+				if (c.slack >= wmax) {
+					//enough weight is still watched; stop watching this (false) term
+					c.terms[w.termIndex].watched = false;
+					continue;
+				}
+				ws[j++] = w;
+				if (c.slack < 0) {
+					//every non-false term is watched, and together they can no longer reach k
+					stats_conflicts++;
+					conflict.clear();
+					explain(c, pos, 0, conflict);
+					has_conflict = true;
+				} else {
+					//any unassigned term heavier than the slack must be true
+					for (int t = 0; t < c.terms.size() && c.terms[t].weight > c.slack; t++) {
+						Lit l = c.terms[t].l;
+						if (S->value(l) == l_Undef) {
+							stats_implied_lits++;
+							reason_constraint[var(l)] = w.constraintID;
+							reason_bound[var(l)] = pos;
+							S->enqueue(l, reason_marker);
+						}
+					}
+				}
+			}
+			ws.shrink(i - j);
+		}
+		propagationtime += rtime(2) - startproptime;
+		return !has_conflict;
+	}
+
+	inline bool solveTheory(vec<Lit> & conflict) {
+		return propagateTheory(conflict);
+	}
+
+	inline void buildReason(Lit p, vec<Lit> & reason, CRef marker) {
+		assert(marker == reason_marker);
+		assert(S->value(p) == l_True);
+		stats_reasons++;
+		int constraintID = reason_constraint[var(p)];
+		assert(constraintID >= 0);
+		PbConstraint & c = constraints[constraintID];
+		int64_t weight = 0;
+		for (Term & t : c.terms) {
+			if (t.l == p) {
+				weight = t.weight;
+				break;
+			}
+		}
+		reason.push(p);
+		explain(c, reason_bound[var(p)], weight, reason);
+	}
+
+	bool check_solved() {
+		for (PbConstraint & c : constraints) {
+			int64_t sum = 0;
+			for (Term & t : c.terms) {
+				if (S->value(t.l) == l_True)
+					sum += t.weight;
+			}
+			if (sum < c.k)
+				return false;
+		}
+		return true;
+	}
+
+	void printStats(int detailLevel) {
+		printf("Watched PB Theory %d stats:\n", this->getTheoryIndex());
+		printf("Constraints: %d (%ld added as clauses)\n", constraints.size(), stats_constraints_as_clauses);
+		printf("Propagations: %ld (%f s, avg: %f s), %ld implied lits, %ld watch replacements\n", stats_propagations,
+				propagationtime, (propagationtime) / ((double) stats_propagations + 1), stats_implied_lits,
+				stats_watch_replacements);
+		printf("Conflicts: %ld\n", stats_conflicts);
+		printf("Reasons: %ld\n", stats_reasons);
+		fflush(stdout);
+	}
+};
+
+}
+;
+
+#endif /* WATCHEDPBTHEORY_H_ */
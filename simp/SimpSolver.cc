@@ -470,6 +470,155 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c) {
 	elimclauses.push(c.size());
 }
 
+// Inprocessing: if the simplifier is still active, its occurrence lists track the problem clauses, so only the learnt
+// clauses may be modified here (the problem clauses will be simplified by 'eliminate()' instead).
+// Otherwise, after vivification and subsumption, eliminate pure Boolean variables that have become cheap to eliminate.
+bool SimpSolver::inprocess() {
+	if (use_simplification)
+		return inprocessClauses(false);
+	if (!inprocessClauses(true))
+		return false;
+	if (!use_elim || !opt_pre || !opt_inprocess_elim)
+		return true;
+	double start_time = rtime(1);
+	int64_t budget = opt_inprocess_effort;
+	bool res = inprocessElim(budget);
+	stats_inprocess_time += rtime(1) - start_time;
+	return res;
+}
+
+struct ElimOccLt {
+	const vec<vec<CRef> >& occ;
+	ElimOccLt(const vec<vec<CRef> >& occ) :
+			occ(occ) {
+	}
+	bool operator()(Var x, Var y) const {
+		return occ[x].size() < occ[y].size();
+	}
+};
+
+// Bounded variable elimination of variables that are not frozen, not theory atoms and not assumptions,
+// using temporary occurrence lists (the simplifier's own occurrence lists are freed once it is turned off).
+bool SimpSolver::inprocessElim(int64_t & budget) {
+	assert(decisionLevel() == 0);
+	assert(!use_simplification);
+	vec<vec<CRef> > occ(nVars());
+	for (CRef cr : clauses) {
+		const Clause & c = ca[cr];
+		if (c.mark() != 0)
+			continue;
+		for (int i = 0; i < c.size(); i++)
+			occ[var(c[i])].push(cr);
+		budget -= c.size();
+	}
+	vec<vec<CRef> > learnt_occ(nVars());
+	for (CRef cr : learnts) {
+		const Clause & c = ca[cr];
+		if (c.mark() != 0)
+			continue;
+		for (int i = 0; i < c.size(); i++)
+			learnt_occ[var(c[i])].push(cr);
+	}
+	vec<char> assumed(nVars(), 0);
+	for (Lit l : assumptions)
+		assumed[var(l)] = 1;
+	vec<Var> candidates;
+	for (Var v = 0; v < nVars(); v++) {
+		if (value(v) == l_Undef && !frozen[v] && !isEliminated(v) && isDecisionVar(v) && !hasTheory(v) && !assumed[v]
+				&& occ[v].size() > 0)
+			candidates.push(v);
+	}
+	sort(candidates, ElimOccLt(occ));
+	
+	int n_eliminated = 0;
+	vec<CRef> pos, neg;
+	vec<Lit> resolvent;
+	for (int n = 0; n < candidates.size() && budget > 0 && ok; n++) {
+		Var v = candidates[n];
+		if (value(v) != l_Undef)
+			continue;
+		pos.clear();
+		neg.clear();
+		for (CRef cr : occ[v]) {
+			const Clause & c = ca[cr];
+			if (c.mark() != 0)
+				continue;
+			for (int i = 0; i < c.size(); i++) {
+				if (var(c[i]) == v) {
+					if (sign(c[i]))
+						neg.push(cr);
+					else
+						pos.push(cr);
+					break;
+				}
+			}
+		}
+		// Check whether the increase in number of clauses stays within the allowed ('grow'):
+		int cnt = 0;
+		int clause_size = 0;
+		bool too_costly = false;
+		for (int i = 0; i < pos.size() && !too_costly; i++) {
+			for (int j = 0; j < neg.size(); j++) {
+				budget -= ca[pos[i]].size() + ca[neg[j]].size();
+				if (merge(ca[pos[i]], ca[neg[j]], v, clause_size)
+						&& (++cnt > pos.size() + neg.size() + grow || (clause_lim != -1 && clause_size > clause_lim))) {
+					too_costly = true;
+					break;
+				}
+			}
+		}
+		if (too_costly)
+			continue;
+		
+		eliminated[v] = true;
+		setDecisionVar(v, false);
+		eliminated_vars++;
+		n_eliminated++;
+		if (pos.size() > neg.size()) {
+			for (int i = 0; i < neg.size(); i++)
+				mkElimClause(elimclauses, v, ca[neg[i]]);
+			mkElimClause(elimclauses, mkLit(v));
+		} else {
+			for (int i = 0; i < pos.size(); i++)
+				mkElimClause(elimclauses, v, ca[pos[i]]);
+			mkElimClause(elimclauses, ~mkLit(v));
+		}
+		for (int i = 0; i < pos.size(); i++)
+			removeClause(pos[i]);
+		for (int i = 0; i < neg.size(); i++)
+			removeClause(neg[i]);
+		//learnt clauses over the eliminated variable are no longer needed, and must not propagate it
+		for (CRef cr : learnt_occ[v]) {
+			if (ca[cr].mark() == 0)
+				removeClause(cr);
+		}
+		
+		for (int i = 0; i < pos.size() && ok; i++) {
+			for (int j = 0; j < neg.size(); j++) {
+				if (merge(ca[pos[i]], ca[neg[j]], v, resolvent)) {
+					int n_clauses = clauses.size();
+					if (!Solver::addClause_(resolvent))
+						break;
+					if (clauses.size() > n_clauses) {
+						const Clause & c = ca[clauses.last()];
+						for (int k = 0; k < c.size(); k++)
+							occ[var(c[k])].push(clauses.last());
+					}
+				}
+			}
+		}
+		occ[v].clear(true);
+		learnt_occ[v].clear(true);
+	}
+	stats_inprocess_eliminated_vars += n_eliminated;
+	if (n_eliminated > 0) {
+		removeMarked(clauses);
+		removeMarked(learnts);
+		checkGarbage();
+	}
+	return ok;
+}
+
 bool SimpSolver::eliminateVar(Var v) {
 	assert(!frozen[v]);
 	assert(!isEliminated(v));
@@ -526,6 +675,10 @@ bool SimpSolver::eliminateVar(Var v) {
 		watches[mkLit(v)].clear(true);
 	if (watches[~mkLit(v)].size() == 0)
 		watches[~mkLit(v)].clear(true);
+	if (binary_watches[mkLit(v)].size() == 0)
+		binary_watches[mkLit(v)].clear(true);
+	if (binary_watches[~mkLit(v)].size() == 0)
+		binary_watches[~mkLit(v)].clear(true);
 	
 	return backwardSubsumptionCheck();
 }
@@ -709,10 +862,12 @@ void SimpSolver::garbageCollect() {
 	
 	cleanUpClauses();
 	to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
+	to.saved_pos_min_size = ca.saved_pos_min_size;
 	relocAll(to);
 	Solver::relocAll(to);
 	if (verbosity >= 2)
-		printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n",
-				ca.size() * ClauseAllocator::Unit_Size, to.size() * ClauseAllocator::Unit_Size);
+		printf("|  Garbage collection:   %12llu bytes => %12llu bytes             |\n",
+				(unsigned long long) ca.size() * ClauseAllocator::Unit_Size,
+				(unsigned long long) to.size() * ClauseAllocator::Unit_Size);
 	to.moveTo(ca);
 }
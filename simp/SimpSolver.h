@@ -99,6 +99,7 @@ public:
 	}
 
 	bool eliminate(bool turn_off_elim = false);  // Perform variable elimination based simplification. 
+	bool inprocess() override;                   // Simplify the clause database between restarts (including variable elimination).
 			
 	// Memory managment:
 	//
@@ -198,6 +199,7 @@ protected:
 	bool merge(const Clause& _ps, const Clause& _qs, Var v, int& size);
 	bool backwardSubsumptionCheck(bool verbose = false);
 	bool eliminateVar(Var v);
+	bool inprocessElim(int64_t& budget);
 	void extendModel();
 
 	void removeClause(CRef cr);
@@ -0,0 +1,112 @@
+/****************************************************************************************[Profile.h]
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef MONOSAT_PROFILE_H_
+#define MONOSAT_PROFILE_H_
+
+#include <cstdint>
+#include <ostream>
+#include "utils/System.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define MONOSAT_PROFILE_RDTSC
+#endif
+
+//Lightweight, always-on instrumentation for the hot theory paths.
+//Timers read the time stamp counter (a handful of cycles) instead of clock_gettime, and accumulate into
+//ProfileCounters that are only converted to seconds when stats are reported.
+//Compile with -DMONOSAT_NO_PROFILE to remove the timers and counters entirely (cycleCount() itself remains available).
+namespace Monosat {
+
+static inline uint64_t cycleCount() {
+#if defined(MONOSAT_PROFILE_RDTSC)
+	return __rdtsc();
+#else
+	return (uint64_t) (fastTime() * 1000000000.0);
+#endif
+}
+
+//Seconds per cycleCount() tick, calibrated against fastTime() the first time it is needed.
+static inline double secondsPerCycle() {
+	static double seconds_per_cycle = 0;
+	if (seconds_per_cycle == 0) {
+		double start_time = fastTime();
+		uint64_t start_cycles = cycleCount();
+		double elapsed = 0;
+		while ((elapsed = fastTime() - start_time) < 0.002) {
+		}
+		uint64_t cycles = cycleCount() - start_cycles;
+		seconds_per_cycle = cycles > 0 ? elapsed / (double) cycles : 1e-9;
+	}
+	return seconds_per_cycle;
+}
+
+struct ProfileCounter {
+	uint64_t calls = 0;
+	uint64_t cycles = 0;
+
+	inline void add(uint64_t elapsed_cycles) {
+#ifndef MONOSAT_NO_PROFILE
+		calls++;
+		cycles += elapsed_cycles;
+#endif
+	}
+	double seconds() const {
+		return cycles ? (double) cycles * secondsPerCycle() : 0;
+	}
+	void clear() {
+		calls = 0;
+		cycles = 0;
+	}
+	void writeJSON(std::ostream & out) const {
+		out << "{\"calls\":" << calls << ",\"seconds\":" << seconds() << "}";
+	}
+};
+
+//Adds the cycles spent in the enclosing scope (and one call) to a ProfileCounter.
+class ScopedProfile {
+#ifndef MONOSAT_NO_PROFILE
+	ProfileCounter & counter;
+	uint64_t start;
+public:
+	explicit ScopedProfile(ProfileCounter & counter) :
+			counter(counter), start(cycleCount()) {
+	}
+	~ScopedProfile() {
+		counter.add(cycleCount() - start);
+	}
+#else
+public:
+	explicit ScopedProfile(ProfileCounter & counter) {
+	}
+#endif
+	ScopedProfile(const ScopedProfile&) = delete;
+	ScopedProfile& operator=(const ScopedProfile&) = delete;
+};
+
+}
+;
+#endif
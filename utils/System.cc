@@ -27,8 +27,8 @@
 
 using namespace Monosat;
 
-// TODO: split the memory reading functions into two: one for reading high-watermark of RSS, and
-// one for reading the current virtual memory size.
+// Memory is reported as resident set size: the clause arena reserves a large virtual address range up
+// front and commits it lazily, so the virtual memory size (VmSize/VmPeak) says little about actual use.
 
 static inline int memReadStat(int field) {
 	char name[256];
@@ -56,9 +56,9 @@ static inline int memReadPeak(void) {
 	if (in == NULL)
 		return 0;
 	
-	// Find the correct line, beginning with "VmPeak:":
+	// Find the correct line, beginning with "VmHWM:" (the high-watermark of the resident set size):
 	int peak_kb = 0;
-	while (!feof(in) && fscanf(in, "VmPeak: %d kB", &peak_kb) != 1)
+	while (!feof(in) && fscanf(in, "VmHWM: %d kB", &peak_kb) != 1)
 		while (!feof(in) && fgetc(in) != '\n')
 			;
 	fclose(in);
@@ -67,7 +67,7 @@ static inline int memReadPeak(void) {
 }
 
 double Monosat::memUsed() {
-	return (double) memReadStat(0) * (double) getpagesize() / (1024 * 1024);
+	return (double) memReadStat(1) * (double) getpagesize() / (1024 * 1024);
 }
 double Monosat::memUsedPeak() {
 	double peak = memReadPeak() / 1024.0;